@@ -0,0 +1,343 @@
+#include "base64.h"
+#include "simd.h"
+
+
+static const char* const ALPHABETS[2] =
+{
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/",
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_",
+};
+
+// The characters for 62 and 63, the only ones that differ between the alphabets.
+static const u8 CHARACTER_62[2] = { '+', '-' };
+static const u8 CHARACTER_63[2] = { '/', '_' };
+
+
+struct Base64_Decode_Table
+{
+    u8 values[256];  // 0xFF for characters outside the alphabet.
+};
+
+static constexpr Base64_Decode_Table make_decode_table(u8 character_62, u8 character_63)
+{
+    Base64_Decode_Table table = {};
+    for (u32 c = 0; c < 256; c++)
+        table.values[c] = 0xFF;
+    for (u32 i = 0; i < 26; i++)
+    {
+        table.values['A' + i] = (u8) i;
+        table.values['a' + i] = (u8)(26 + i);
+    }
+    for (u32 i = 0; i < 10; i++)
+        table.values['0' + i] = (u8)(52 + i);
+    table.values[character_62] = 62;
+    table.values[character_63] = 63;
+    return table;
+}
+
+static constexpr Base64_Decode_Table DECODE_TABLES[2] =
+{
+    make_decode_table('+', '/'),
+    make_decode_table('-', '_'),
+};
+
+
+//
+// Encoding.
+//
+
+
+#ifdef SIMD_SSSE3
+
+// Turns each 3 bytes of the low 12 into 4 characters. 'shifts' is what encode_base64 sets up per alphabet.
+static inline __m128i encode_12_bytes(__m128i input, __m128i shifts)
+{
+    // Spread each 3 bytes over a 32-bit lane as b1 b0 b2 b1, then move the four 6-bit fields
+    // into the low bits of the four bytes with two multiplies.
+    input = _mm_shuffle_epi8(input, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+    __m128i high = _mm_mulhi_epu16(_mm_and_si128(input, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040));
+    __m128i low  = _mm_mullo_epi16(_mm_and_si128(input, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010));
+    __m128i indices = _mm_or_si128(high, low);
+
+    // Pick the shift to add by range: 0-25 to 13, 26-51 to 0, 52-61 to 1-10, 62 to 11 and 63 to 12.
+    __m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    __m128i is_upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    range = _mm_or_si128(range, _mm_and_si128(is_upper, _mm_set1_epi8(13)));
+    return _mm_add_epi8(indices, _mm_shuffle_epi8(shifts, range));
+}
+
+#endif
+
+#ifdef SIMD_AVX2
+
+static inline __m256i encode_24_bytes(__m256i input, __m256i shifts)
+{
+    input = _mm256_shuffle_epi8(input, _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+                                                        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+    __m256i high = _mm256_mulhi_epu16(_mm256_and_si256(input, _mm256_set1_epi32(0x0FC0FC00)), _mm256_set1_epi32(0x04000040));
+    __m256i low  = _mm256_mullo_epi16(_mm256_and_si256(input, _mm256_set1_epi32(0x003F03F0)), _mm256_set1_epi32(0x01000010));
+    __m256i indices = _mm256_or_si256(high, low);
+
+    __m256i range = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+    __m256i is_upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+    range = _mm256_or_si256(range, _mm256_and_si256(is_upper, _mm256_set1_epi8(13)));
+    return _mm256_add_epi8(indices, _mm256_shuffle_epi8(shifts, range));
+}
+
+#endif
+
+
+void encode_base64(Binary_Writer* writer, String data, Base64_Alphabet alphabet, bool padding)
+{
+    DebugAssert(writer->cursor + get_base64_encoded_length(data.length, padding) <= writer->end);
+
+    const u8* in = data.data;
+    const u8* in_end = data.data + data.length;
+    u8* out = writer->cursor;
+
+#if defined(SIMD_SSSE3) || defined(SIMD_AVX2)
+    i8 shift_62 = (i8)(CHARACTER_62[alphabet] - 62);
+    i8 shift_63 = (i8)(CHARACTER_63[alphabet] - 63);
+#endif
+
+#ifdef SIMD_AVX2
+    // Each half loads 16 bytes and uses 12, so 28 bytes have to be readable.
+    __m256i shifts_256 = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                          '0' - 52, '0' - 52, '0' - 52, '0' - 52, shift_62, shift_63, 'A', 0, 0,
+                                          'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                          '0' - 52, '0' - 52, '0' - 52, '0' - 52, shift_62, shift_63, 'A', 0, 0);
+    while (in_end - in >= 28)
+    {
+        __m256i input = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*) in)),
+                                                _mm_loadu_si128((const __m128i*)(in + 12)), 1);
+        _mm256_storeu_si256((__m256i*) out, encode_24_bytes(input, shifts_256));
+        in += 24;
+        out += 32;
+    }
+#endif
+
+#ifdef SIMD_SSSE3
+    __m128i shifts = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                   '0' - 52, '0' - 52, '0' - 52, '0' - 52, shift_62, shift_63, 'A', 0, 0);
+    while (in_end - in >= 16)
+    {
+        __m128i input = _mm_loadu_si128((const __m128i*) in);
+        _mm_storeu_si128((__m128i*) out, encode_12_bytes(input, shifts));
+        in += 12;
+        out += 16;
+    }
+#endif
+
+    const char* characters = ALPHABETS[alphabet];
+    for (; in_end - in >= 3; in += 3, out += 4)
+    {
+        u32 group = ((u32) in[0] << 16) | ((u32) in[1] << 8) | in[2];
+        out[0] = characters[(group >> 18) & 63];
+        out[1] = characters[(group >> 12) & 63];
+        out[2] = characters[(group >>  6) & 63];
+        out[3] = characters[ group        & 63];
+    }
+
+    umm remaining = in_end - in;
+    if (remaining)
+    {
+        u32 group = (u32) in[0] << 16;
+        if (remaining == 2)
+            group |= (u32) in[1] << 8;
+
+        *(out++) = characters[(group >> 18) & 63];
+        *(out++) = characters[(group >> 12) & 63];
+        if (remaining == 2)
+            *(out++) = characters[(group >> 6) & 63];
+
+        if (padding)
+        {
+            *(out++) = '=';
+            if (remaining == 1)
+                *(out++) = '=';
+        }
+    }
+
+    writer->cursor = out;
+}
+
+
+void encode_base64(String_Builder* builder, String data, Base64_Alphabet alphabet, bool padding)
+{
+    Binary_Writer writer = begin_binary_write(builder, get_base64_encoded_length(data.length, padding));
+    encode_base64(&writer, data, alphabet, padding);
+    end_binary_write(builder, &writer);
+}
+
+
+//
+// Decoding.
+//
+
+
+#ifdef SIMD_SSSE3
+
+// Turns 16 characters into 12 bytes, in the low 12 bytes of 'result'.
+// Returns false if any of the characters is outside the alphabet.
+static inline bool decode_16_characters(__m128i input, __m128i character_62, __m128i character_63,
+                                        __m128i shift_62, __m128i shift_63, __m128i* result)
+{
+    // Signed compares, so bytes from 0x80 up are in no range.
+    __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(input, _mm_set1_epi8('A' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), input));
+    __m128i lower = _mm_and_si128(_mm_cmpgt_epi8(input, _mm_set1_epi8('a' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('z' + 1), input));
+    __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(input, _mm_set1_epi8('0' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), input));
+    __m128i is_62 = _mm_cmpeq_epi8(input, character_62);
+    __m128i is_63 = _mm_cmpeq_epi8(input, character_63);
+
+    __m128i valid = _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, _mm_or_si128(is_62, is_63)));
+    if (_mm_movemask_epi8(valid) != 0xFFFF)
+        return false;
+
+    __m128i shift = _mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(-'A')),
+                                 _mm_and_si128(lower, _mm_set1_epi8(26 - 'a')));
+    shift = _mm_or_si128(shift, _mm_and_si128(digit, _mm_set1_epi8(52 - '0')));
+    shift = _mm_or_si128(shift, _mm_or_si128(_mm_and_si128(is_62, shift_62), _mm_and_si128(is_63, shift_63)));
+    __m128i values = _mm_add_epi8(input, shift);
+
+    // Join pairs of 6-bit values into 12 bits, then pairs of those into 24, and put the bytes in order.
+    __m128i pairs = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    __m128i groups = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+    *result = _mm_shuffle_epi8(groups, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    return true;
+}
+
+#endif
+
+#ifdef SIMD_AVX2
+
+// Turns 32 characters into 24 bytes, in the low 24 bytes of 'result'.
+static inline bool decode_32_characters(__m256i input, __m256i character_62, __m256i character_63,
+                                        __m256i shift_62, __m256i shift_63, __m256i* result)
+{
+    __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(input, _mm256_set1_epi8('A' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), input));
+    __m256i lower = _mm256_and_si256(_mm256_cmpgt_epi8(input, _mm256_set1_epi8('a' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), input));
+    __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(input, _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), input));
+    __m256i is_62 = _mm256_cmpeq_epi8(input, character_62);
+    __m256i is_63 = _mm256_cmpeq_epi8(input, character_63);
+
+    __m256i valid = _mm256_or_si256(_mm256_or_si256(upper, lower), _mm256_or_si256(digit, _mm256_or_si256(is_62, is_63)));
+    if ((u32) _mm256_movemask_epi8(valid) != 0xFFFFFFFF)
+        return false;
+
+    __m256i shift = _mm256_or_si256(_mm256_and_si256(upper, _mm256_set1_epi8(-'A')),
+                                    _mm256_and_si256(lower, _mm256_set1_epi8(26 - 'a')));
+    shift = _mm256_or_si256(shift, _mm256_and_si256(digit, _mm256_set1_epi8(52 - '0')));
+    shift = _mm256_or_si256(shift, _mm256_or_si256(_mm256_and_si256(is_62, shift_62), _mm256_and_si256(is_63, shift_63)));
+    __m256i values = _mm256_add_epi8(input, shift);
+
+    __m256i pairs = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+    __m256i groups = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+    groups = _mm256_shuffle_epi8(groups, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                                          2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+
+    // Each half has its 12 bytes at the bottom, move the upper half's down next to the lower half's.
+    *result = _mm256_permutevar8x32_epi32(groups, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+    return true;
+}
+
+#endif
+
+
+bool decode_base64(String text, String* result, Region* memory, Base64_Alphabet alphabet, umm* error_offset)
+{
+    ZeroStruct(result);
+
+    umm length = text.length;
+    if (length && text.data[length - 1] == '=') length--;
+    if (length && text.data[length - 1] == '=') length--;
+
+    // One character left over can't be decoded to anything, and padding has to fill out the last group.
+    bool has_padding = length != text.length;
+    if (length % 4 == 1 || (has_padding && text.length % 4))
+    {
+        if (error_offset) *error_offset = text.length;
+        return false;
+    }
+
+    // The SIMD stores write a few bytes past the data.
+    umm max_length = length / 4 * 3 + 2;
+    u8* out = LK_RegionArray(memory, u8, max_length + 8);
+    u8* out_start = out;
+
+    const u8* in = text.data;
+    const u8* in_end = text.data + length;
+
+#if defined(SIMD_SSSE3) || defined(SIMD_AVX2)
+    i8 shift_62 = (i8)(62 - CHARACTER_62[alphabet]);
+    i8 shift_63 = (i8)(63 - CHARACTER_63[alphabet]);
+#endif
+
+    // The SIMD loops stop at the first block with a bad character, and leave finding it to the scalar loop.
+#ifdef SIMD_AVX2
+    {
+        __m256i character_62 = _mm256_set1_epi8((char) CHARACTER_62[alphabet]);
+        __m256i character_63 = _mm256_set1_epi8((char) CHARACTER_63[alphabet]);
+        __m256i shift_62_256 = _mm256_set1_epi8(shift_62);
+        __m256i shift_63_256 = _mm256_set1_epi8(shift_63);
+        for (; in_end - in >= 32; in += 32, out += 24)
+        {
+            __m256i decoded;
+            __m256i input = _mm256_loadu_si256((const __m256i*) in);
+            if (!decode_32_characters(input, character_62, character_63, shift_62_256, shift_63_256, &decoded))
+                break;
+            _mm256_storeu_si256((__m256i*) out, decoded);
+        }
+    }
+#endif
+
+#ifdef SIMD_SSSE3
+    {
+        __m128i character_62 = _mm_set1_epi8((char) CHARACTER_62[alphabet]);
+        __m128i character_63 = _mm_set1_epi8((char) CHARACTER_63[alphabet]);
+        __m128i shift_62_128 = _mm_set1_epi8(shift_62);
+        __m128i shift_63_128 = _mm_set1_epi8(shift_63);
+        for (; in_end - in >= 16; in += 16, out += 12)
+        {
+            __m128i decoded;
+            __m128i input = _mm_loadu_si128((const __m128i*) in);
+            if (!decode_16_characters(input, character_62, character_63, shift_62_128, shift_63_128, &decoded))
+                break;
+            _mm_storeu_si128((__m128i*) out, decoded);
+        }
+    }
+#endif
+
+    const u8* values = DECODE_TABLES[alphabet].values;
+    while (in < in_end)
+    {
+        // The last group can have 2 or 3 characters.
+        umm count = (in_end - in < 4) ? in_end - in : 4;
+        u32 group = 0;
+        u32 invalid = 0;
+        for (umm i = 0; i < count; i++)
+        {
+            u32 value = values[in[i]];
+            invalid |= value;
+            group |= value << (18 - 6 * i);
+        }
+
+        if (invalid & 0x80)
+        {
+            umm i = 0;
+            while (values[in[i]] != 0xFF)
+                i++;
+            if (error_offset) *error_offset = in + i - text.data;
+            return false;
+        }
+
+        out[0] = (u8)(group >> 16);
+        out[1] = (u8)(group >> 8);
+        out[2] = (u8) group;
+        out += count - 1;
+        in += count;
+    }
+
+    result->data = out_start;
+    result->length = out - out_start;
+    return true;
+}
@@ -1,973 +1,3370 @@
-#include "common.h"
-
-#include <stdlib.h>
-
-
-/*
- *
- * -- implementation of common.h subitems that need .cpp implementation
- *
- */
-
-
-//
-//
-// -- temporary memory
-//
-//
-
-Region temporary_memory = {};
-
-
-
-
-//
-//
-// -- string utility
-//
-//
-
-//
-// Memory, character and C-style string utilities.
-//
-
-
-void copy(void* to, const void* from, umm length)
-{
-    u8* to_bytes   = (u8*) to;
-    u8* from_bytes = (u8*) from;
-    for (umm i = 0; i < length; i++)
-        *(to_bytes++) = *(from_bytes++);
-}
-
-void move(void* to, void* from, umm length)
-{
-    if (to < from)
-    {
-        u8* to_bytes   = (u8*) to;
-        u8* from_bytes = (u8*) from;
-        for (umm i = 0; i < length; i++)
-            *(to_bytes++) = *(from_bytes++);
-    }
-    else
-    {
-        u8* to_bytes   = (u8*) to   + length;
-        u8* from_bytes = (u8*) from + length;
-        for (umm i = 0; i < length; i++)
-            *(--to_bytes) = *(--from_bytes);
-    }
-}
-
-bool compare(const void* m1, const void* m2, umm length)
-{
-    const u8* bytes1 = (const u8*) m1;
-    const u8* bytes2 = (const u8*) m2;
-
-    for (umm i = 0; i < length; i++)
-    {
-        if (*bytes1 != *bytes2)
-            return false;
-
-        bytes1++;
-        bytes2++;
-    }
-
-    return true;
-}
-
-
-u16 endian_swap16(u16 value)
-{
-    return (value << 8) | (value >> 8);
-}
-
-u32 endian_swap32(u32 value)
-{
-    return (value << 24) | (value >> 24) |
-           ((value << 8) & 0xff0000ul) |
-           ((value >> 8) & 0x00ff00ul);
-}
-
-u64 endian_swap64(u64 value)
-{
-    u32 low32  = (u32) value;
-    u32 high32 = (u32)(value >> 32);
-
-    u32 new_low32  = endian_swap32(high32);
-    u32 new_high32 = endian_swap32(low32);
-
-    return (u64) new_low32 | ((u64) new_high32 << 32);
-}
-
-
-static String line_ending_chars = "\n\r"_s;
-static String whitespace_chars = " \t\n\r"_s;
-static String slash_chars = "/\\"_s;
-
-bool is_decimal_digit(u8 character)
-{
-    return character >= '0' && character <= '9';
-}
-
-bool is_whitespace(u8 character)
-{
-    if (character == ' ')  return true;
-    if (character == '\t') return true;
-    if (character == '\n') return true;
-    if (character == '\r') return true;
-
-    return false;
-}
-
-
-umm length_of_c_style_string(const char* c_string)
-{
-    umm length = 0;
-    while (c_string[length])
-        length++;
-    return length;
-}
-
-umm length_of_c_style_string(const u16* c_string)
-{
-    umm length = 0;
-    while (c_string[length])
-        length++;
-    return length;
-}
-
-
-//
-// 8-bit strings.
-// When treated as text, UTF-8 encoding is assumed.
-//
-
-
-String make_string(const char* c_string)
-{
-    umm length = length_of_c_style_string(c_string);
-
-    String result;
-    result.length = length;
-    result.data = LK_RegionArray(temp, u8, length);
-
-    copy(result.data, c_string, length);
-
-    return result;
-}
-
-char* make_c_style_string(String string)
-{
-    char* result = LK_RegionArray(temp, char, string.length + 1);
-
-    copy(result, string.data, string.length);
-    result[string.length] = 0;
-
-    return result;
-}
-
-String wrap_string(const char* c_string)
-{
-    String result;
-    result.length = length_of_c_style_string(c_string);
-    result.data = (u8*) c_string;
-    return result;
-}
-
-
-String allocate_string(Region* memory, String string)
-{
-    String result;
-    result.length = string.length;
-    result.data = LK_RegionArray(memory, u8, string.length);
-
-    copy(result.data, string.data, string.length);
-
-    return result;
-}
-
-
-String clone_string(String string)
-{
-    return allocate_string(temp, string);
-}
-
-
-String concatenate(String first, String second, String third, String fourth, String fifth, String sixth)
-{
-    String result;
-    result.length = first.length + second.length + third.length + fourth.length + fifth.length + sixth.length;
-    result.data = LK_RegionArray(temp, u8, result.length);
-
-    u8* write = result.data;
-
-    copy(write, first.data, first.length);
-    write += first.length;
-
-    copy(write, second.data, second.length);
-    write += second.length;
-
-    copy(write, third.data, third.length);
-    write += third.length;
-
-    copy(write, fourth.data, fourth.length);
-    write += fourth.length;
-
-    copy(write, fifth.data, fifth.length);
-    write += fifth.length;
-
-    copy(write, sixth.data, sixth.length);
-    write += sixth.length;
-
-    return result;
-}
-
-
-String substring(String string, umm start_index, umm length)
-{
-    DebugAssert(start_index <= string.length);
-    DebugAssert((start_index + length) <= string.length);
-
-    String result;
-    result.length = length;
-    result.data = string.data + start_index;
-
-    return result;
-}
-
-// concatenates everything from left[0] to right[end]
-String concatenate_adjacent_substrings(String left, String right, String parent)
-{
-    if (left.data == NULL && left.length == 0) // left string can be empty
-        return right;
-
-    DebugAssert(left.data >= parent.data);
-    DebugAssert(right.data + right.length <= parent.data + parent.length);
-
-    String result;
-    result.data = left.data;
-    result.length = left.length + right.length;
-
-    return result;
-}
-
-
-bool operator==(String lhs, String rhs)
-{
-    if (lhs.length != rhs.length)
-        return false;
-    return compare(lhs.data, rhs.data, lhs.length);
-}
-
-bool operator==(String lhs, const char* rhs)
-{
-    umm rhs_length = length_of_c_style_string(rhs);
-    if (lhs.length != rhs_length)
-        return false;
-    return compare(lhs.data, rhs, lhs.length);
-}
-
-bool operator==(const char* lhs, String rhs)
-{
-    umm lhs_length = length_of_c_style_string(lhs);
-    if (lhs_length != rhs.length)
-        return false;
-    return compare(lhs, rhs.data, lhs_length);
-}
-
-
-bool prefix_equals(String string, String prefix)
-{
-    if (string.length < prefix.length)
-        return false;
-
-    return compare(string.data, prefix.data, prefix.length);
-}
-
-bool suffix_equals(String string, String suffix)
-{
-    if (string.length < suffix.length)
-        return false;
-
-    u8* substring = string.data + string.length - suffix.length;
-    return compare(substring, suffix.data, suffix.length);
-}
-
-
-umm find_first_occurance(String string, u8 of)
-{
-    for (imm i = 0; i < string.length; i++)
-        if (string[i] == of)
-            return i;
-
-    return NOT_FOUND;
-}
-
-umm find_first_occurance(String string, String of)
-{
-    if (string.length < of.length)
-        return NOT_FOUND;
-
-    for (imm i = 0; i <= string.length - of.length; i++)
-        if (compare(string.data + i, of.data, of.length))
-            return i;
-
-    return NOT_FOUND;
-}
-
-umm find_first_occurance_of_any(String string, String any_of)
-{
-    for (imm i = 0; i < string.length; i++)
-    {
-        u8 c = string[i];
-
-        for (umm j = 0; j < any_of.length; j++)
-        {
-            u8 c2 = any_of[j];
-            if (c == c2)
-                return i;
-        }
-    }
-
-    return NOT_FOUND;
-}
-
-
-umm find_last_occurance(String string, u8 of)
-{
-    for (imm i = string.length - 1; i >= 0; i--)
-        if (string[i] == of)
-            return i;
-
-    return NOT_FOUND;
-}
-
-umm find_last_occurance(String string, String of)
-{
-    if (string.length < of.length)
-        return NOT_FOUND;
-
-    for (imm i = string.length - of.length; i >= 0; i--)
-        if (compare(string.data + i, of.data, of.length))
-            return i;
-
-    return NOT_FOUND;
-}
-
-umm find_last_occurance_of_any(String string, String any_of)
-{
-    for (imm i = string.length - 1; i >= 0; i--)
-    {
-        u8 c = string[i];
-
-        for (umm j = 0; j < any_of.length; j++)
-        {
-            u8 c2 = any_of[j];
-            if (c == c2)
-                return i;
-        }
-    }
-
-    return NOT_FOUND;
-}
-
-
-void replace_all_occurances(String string, u8 what, u8 with_what)
-{
-    for (imm i = string.length - 1; i >= 0; i--)
-        if (string[i] == what)
-            string[i] = with_what;
-}
-
-
-//u32 compute_crc32(String data)
-//{
-//    u32 crc = U32_MAX;
-//
-//    for (umm i = 0; i < data.length; i++)
-//    {
-//        crc = crc ^ data.data[i];
-//        crc = (crc >> 1) ^ (0xedb88320 & -(crc & 1));
-//        crc = (crc >> 1) ^ (0xedb88320 & -(crc & 1));
-//        crc = (crc >> 1) ^ (0xedb88320 & -(crc & 1));
-//        crc = (crc >> 1) ^ (0xedb88320 & -(crc & 1));
-//        crc = (crc >> 1) ^ (0xedb88320 & -(crc & 1));
-//        crc = (crc >> 1) ^ (0xedb88320 & -(crc & 1));
-//        crc = (crc >> 1) ^ (0xedb88320 & -(crc & 1));
-//        crc = (crc >> 1) ^ (0xedb88320 & -(crc & 1));
-//    }
-//
-//    return ~crc;
-//}
-
-
-//
-//
-// Text reading utilities.
-//
-//
-
-
-void consume(String* string, umm amount)
-{
-    DebugAssert(amount <= string->length);
-    string->data += amount;
-    string->length -= amount;
-}
-
-void consume_whitespace(String* string)
-{
-    while (*string && is_whitespace(string->data[0]))
-        consume(string, 1);
-}
-
-String consume_line(String* string)
-{
-    consume_whitespace(string);
-
-    umm line_length = find_first_occurance_of_any(*string, line_ending_chars);
-    if (line_length == NOT_FOUND)
-        line_length = string->length;
-
-    String line = substring(*string, 0, line_length);
-    consume(string, line_length);
-
-    return line;
-}
-
-String consume_line_preserve_whitespace(String* string)
-{
-    umm line_length = find_first_occurance_of_any(*string, "\n\r"_s);
-    if (line_length == NOT_FOUND)
-        line_length = string->length;
-
-    String line = substring(*string, 0, line_length);
-    consume(string, line_length);
-
-    // If we've found the line ending, consume it.
-    if (*string)
-    {
-        umm ending_length = 1;
-        if (string->length > 1)
-        {
-            // Handle two-u8 line endings.
-            u8 c1 = string->data[0];
-            u8 c2 = string->data[1];
-            if ((c1 == '\n' && c2 == '\r') ||
-                (c1 == '\r' && c2 == '\n'))
-                ending_length++;
-        }
-        consume(string, ending_length);
-    }
-
-    return line;
-}
-
-String peek_line_preserve_whitespace(String string)
-{
-    umm line_length = find_first_occurance_of_any(string, "\n\r"_s);
-    if (line_length == NOT_FOUND)
-        line_length = string.length;
-
-    String line = substring(string, 0, line_length);
-    consume(&string, line_length);
-
-    // If we've found the line ending, consume it.
-    if (string)
-    {
-        umm ending_length = 1;
-        if (string.length > 1)
-        {
-            // Handle two-u8 line endings.
-            u8 c1 = string.data[0];
-            u8 c2 = string.data[1];
-            if ((c1 == '\n' && c2 == '\r') ||
-                (c1 == '\r' && c2 == '\n'))
-                ending_length++;
-        }
-        consume(&string, ending_length);
-    }
-
-    return line;
-}
-
-String consume_until(String* string, u8 until_what)
-{
-    consume_whitespace(string);
-
-    umm left_length = find_first_occurance(*string, until_what);
-    if (left_length == NOT_FOUND)
-        left_length = string->length;
-
-    String left = substring(*string, 0, left_length);
-    consume(string, left_length);
-
-    // If we've found the delimiter, consume it.
-    if (*string)
-        consume(string, 1);
-
-    return left;
-}
-
-String consume_until(String* string, String until_what)
-{
-    consume_whitespace(string);
-
-    umm left_length = find_first_occurance(*string, until_what);
-    if (left_length == NOT_FOUND)
-        left_length = string->length;
-
-    String left = substring(*string, 0, left_length);
-    consume(string, left_length);
-
-    // If we've found the delimiter, consume it.
-    if (*string)
-        consume(string, until_what.length);
-
-    return left;
-}
-
-String consume_until_any(String* string, String until_what)
-{
-    consume_whitespace(string);
-
-    umm left_length = find_first_occurance_of_any(*string, until_what);
-    if (left_length == NOT_FOUND)
-        left_length = string->length;
-
-    String left = substring(*string, 0, left_length);
-    consume(string, left_length);
-
-    // If we've found the delimiter, consume it.
-    if (*string)
-        consume(string, 1);
-
-    return left;
-}
-
-String consume_until_whitespace(String* string)
-{
-    return consume_until_any(string, whitespace_chars);
-}
-
-
-String trim(String string)
-{
-    while (string && is_whitespace(string[0]))
-        consume(&string, 1);
-    while (string && is_whitespace(string[string.length - 1]))
-        string.length--;
-    return string;
-}
-
-
-//
-//
-// Binary reading utilities.
-//
-//
-
-
-bool read_bytes(String* string, void* result, umm count)
-{
-    if (string->length < count)
-        return false;
-
-    copy(result, string->data, count);
-    consume(string, count);
-    return true;
-}
-
-
-bool read_u8 (String* string, u8*  result) { return read_bytes(string, result, 1); }
-bool read_u16(String* string, u16* result) { return read_bytes(string, result, 2); }
-bool read_u32(String* string, u32* result) { return read_bytes(string, result, 4); }
-bool read_u64(String* string, u64* result) { return read_bytes(string, result, 8); }
-
-bool read_i8 (String* string, i8*  result) { return read_bytes(string, result, 1); }
-bool read_i16(String* string, i16* result) { return read_bytes(string, result, 2); }
-bool read_i32(String* string, i32* result) { return read_bytes(string, result, 4); }
-bool read_i64(String* string, i64* result) { return read_bytes(string, result, 8); }
-
-
-#ifdef BIG_ENDIAN
-#error "Go away, we don't like you!"
-#endif
-
-bool read_u16le(String* string, u16* result) { return read_bytes(string, result, 2); }
-bool read_u32le(String* string, u32* result) { return read_bytes(string, result, 4); }
-bool read_u64le(String* string, u64* result) { return read_bytes(string, result, 8); }
-
-bool read_u16be(String* string, u16* result) { Defer(*result = endian_swap16(*result)); return read_bytes(string, result, 2); }
-bool read_u32be(String* string, u32* result) { Defer(*result = endian_swap32(*result)); return read_bytes(string, result, 4); }
-bool read_u64be(String* string, u64* result) { Defer(*result = endian_swap64(*result)); return read_bytes(string, result, 8); }
-
-bool read_i16le(String* string, i16* result) { return read_bytes(string, result, 2); }
-bool read_i32le(String* string, i32* result) { return read_bytes(string, result, 4); }
-bool read_i64le(String* string, i64* result) { return read_bytes(string, result, 8); }
-
-bool read_i16be(String* string, i16* result) { Defer(*result = (i16) endian_swap16((u16) *result)); return read_bytes(string, result, 2); }
-bool read_i32be(String* string, i32* result) { Defer(*result = (i32) endian_swap32((u32) *result)); return read_bytes(string, result, 4); }
-bool read_i64be(String* string, i64* result) { Defer(*result = (i64) endian_swap64((u64) *result)); return read_bytes(string, result, 8); }
-
-
-//
-// File path utilities.
-//
-
-
-String get_file_name(String path)
-{
-    umm last_slash_index = find_last_occurance_of_any(path, slash_chars);
-    if (last_slash_index == NOT_FOUND)
-        last_slash_index = 0;
-
-    umm start_index = last_slash_index + 1;
-    umm length = path.length - start_index;
-
-    String file_name = substring(path, start_index, length);
-    return file_name;
-}
-
-
-String get_file_name_without_extension(String path)
-{
-    umm last_slash_index = find_last_occurance_of_any(path, slash_chars);
-    if (last_slash_index != NOT_FOUND)
-        consume(&path, last_slash_index + 1);
-
-    umm last_dot_index = find_last_occurance(path, '.');
-    if (last_dot_index != NOT_FOUND)
-        path.length = last_dot_index;
-
-    return path;
-}
-
-
-String get_parent_directory_path(String path)
-{
-    umm last_slash_index = find_last_occurance_of_any(path, slash_chars);
-    // @Incomplete if (last_slash_index == NOT_FOUND)
-
-    String parent = substring(path, 0, last_slash_index);
-    return parent;
-}
-
-
-
-//
-// 16-bit strings. These mostly exist for interfacing with Windows.
-// That's why conversion routines return null terminated strings, and why
-// we don't really support any operations on them.
-//
-
-
-
-static inline bool is_legal_code_point(u32 code_point)
-{
-    if (code_point > 0x10FFFF) return false;
-    if (code_point >= 0xD800 && code_point <= 0xDFFF) return false;
-    return true;
-}
-
-
-static inline u32 get_utf8_sequence_length(u32 code_point)
-{
-    if (code_point <      0x80) return 1;
-    if (code_point <     0x800) return 2;
-    if (code_point <   0x10000) return 3;
-    if (code_point <  0x200000) return 4;
-    if (code_point < 0x4000000) return 5;
-                                return 6;
-}
-
-
-static void encode_utf8_sequence(u32 code_point, u8* target, u32 length)
-{
-    switch (length)
-    {
-    case 6:  target[5] = (u8)((code_point | 0x80) & 0xBF); code_point >>= 6;  // fall-through
-    case 5:  target[4] = (u8)((code_point | 0x80) & 0xBF); code_point >>= 6;  // fall-through
-    case 4:  target[3] = (u8)((code_point | 0x80) & 0xBF); code_point >>= 6;  // fall-through
-    case 3:  target[2] = (u8)((code_point | 0x80) & 0xBF); code_point >>= 6;  // fall-through
-    case 2:  target[1] = (u8)((code_point | 0x80) & 0xBF); code_point >>= 6;  // fall-through
-    }
-
-    static constexpr u8 FIRST_MASK[7] = { 0x00, 0x00, 0xC0, 0xE0, 0xF0, 0xF8, 0xFC };
-    target[0] = (u8)(code_point | FIRST_MASK[length]);
-}
-
-
-static bool decode_utf8_sequence(String* string, u32* out_code_point)
-{
-    umm length = string->length;
-    u8* data = string->data;
-    DebugAssert(length);
-
-    u8 unit1 = data[0];
-    consume(string, 1);
-
-    if (unit1 < 0x80)
-    {
-        *out_code_point = unit1;
-        return true;
-    }
-
-    if (unit1 >= 0x80 && unit1 <= 0xBF)
-        return false;
-
-
-    u32 consume_count = 0;
-    u32 code_point = unit1;
-
-    #define HandleUnit                                  \
-    {                                                   \
-        if (!--length)  return false;                   \
-        u8 unit = data[++consume_count];                \
-        if (unit < 0x80 || unit > 0xBF)  return false;  \
-        code_point = (code_point << 6) + unit;          \
-    }
-
-    if (unit1 >= 0xFC) HandleUnit  // 6 units
-    if (unit1 >= 0xF8) HandleUnit  // 5 units
-    if (unit1 >= 0xF0) HandleUnit  // 4 units
-    if (unit1 >= 0xE0) HandleUnit  // 3 units
-    HandleUnit                     // 2 units
-
-    #undef HandleUnit
-
-
-    static constexpr u32 DECODING_MAGIC[] =
-    {
-        0x00000000,
-        0x00000000, 0x00003080, 0x000E2080,
-        0x03C82080, 0xFA082080, 0x82082080
-    };
-
-    code_point -= DECODING_MAGIC[consume_count + 1];
-    consume(string, consume_count);
-
-    *out_code_point = code_point;
-    return true;
-}
-
-
-static void encode_utf16_sequence(u32 code_point, u16* target, u32 length)
-{
-    if (length == 2)
-    {
-        code_point -= 0x10000;
-        target[0] = 0xD800 + (u16)(code_point >> 10);
-        target[1] = 0xDC00 + (u16)(code_point & 0x3FF);
-        return;
-    }
-
-    target[0] = (u16) code_point;
-}
-
-
-// If this function finds an unpaired surrogate, it will decode it as a
-// code point equal to that surrogate. It is up to the caller to check if
-// the returned value is a legal Unicode code point, if relevant.
-static u32 decode_utf16_sequence(String16* string)
-{
-    DebugAssert(string->length);
-    u32 unit1 = string->data[0];
-    string->data++;
-    string->length--;
-
-    if (unit1 >= 0xD800 && unit1 <= 0xDBFF)
-    {
-        if (!string->length)
-            return unit1;  // Unpaired high surrogate.
-
-        u32 unit2 = string->data[0];
-        if (unit2 < 0xDC00 || unit2 > 0xDFFF)
-            return unit1;  // Unpaired high surrogate.
-
-        string->data++;
-        string->length--;
-        return (((unit1 - 0xD800) << 10) | (unit2 - 0xDC00)) + 0x10000;
-    }
-
-    // Might be an unpaired low surrogate, but it makes no difference.
-    return unit1;
-}
-
-
-static umm convert_utf8_to_utf16(String16* target, String source)
-{
-    umm utf16_length = 0;
-
-    while (source)
-    {
-        u32 code_point;
-        if (!decode_utf8_sequence(&source, &code_point))
-            continue;
-
-        u32 sequence_length = (code_point < 0x10000) ? 1 : 2;
-        if (target)
-        {
-            u16* sequence = target->data + utf16_length;
-            encode_utf16_sequence(code_point, sequence, sequence_length);
-        }
-
-        utf16_length += sequence_length;
-    }
-
-    return utf16_length;
-}
-
-
-static umm convert_utf16_to_utf8(String* target, String16 source)
-{
-    umm utf8_length = 0;
-
-    while (source)
-    {
-        u32 code_point = decode_utf16_sequence(&source);
-
-        u32 sequence_length = get_utf8_sequence_length(code_point);
-        if (target)
-        {
-            u8* sequence = target->data + utf8_length;
-            encode_utf8_sequence(code_point, sequence, sequence_length);
-        }
-
-        utf8_length += sequence_length;
-    }
-
-    return utf8_length;
-}
-
-
-// The returned string is null terminated.
-String16 make_string16(const u16* c_string)
-{
-    umm length = length_of_c_style_string(c_string);
-
-    String16 result;
-    result.length = length;
-    result.data = LK_RegionArray(temp, u16, length + 1);
-
-    copy(result.data, c_string, 2 * (length + 1));
-
-    return result;
-}
-
-// The returned string is null terminated.
-String16 convert_utf8_to_utf16(String string)
-{
-    umm length = convert_utf8_to_utf16(NULL, string);
-
-    String16 string16;
-    string16.length = length;
-    string16.data = LK_RegionArray(temp, u16, length + 1);
-    string16.data[length] = 0;
-
-    length = convert_utf8_to_utf16(&string16, string);
-    DebugAssert(string16.length == length);
-
-    return string16;
-}
-
-// The returned string is null terminated.
-String convert_utf16_to_utf8(String16 string)
-{
-    umm length = convert_utf16_to_utf8(NULL, string);
-
-    String string8;
-    string8.length = length;
-    string8.data = LK_RegionArray(temp, u8, length + 1);
-    string8.data[length] = 0;
-
-    length = convert_utf16_to_utf8(&string8, string);
-    DebugAssert(string8.length == length);
-
-    return string8;
-}
-
-
-
-//
-// String building utilities.
-//
-
-
-
-void free_string_builder(String_Builder* builder)
-{
-    free(builder->string.data);
-    ZeroStruct(builder);
-}
-
-
-void clear(String_Builder* builder)
-{
-    builder->string.length = 0;
-}
-
-
-void maybe_resize(String_Builder* builder, umm insert_length)
-{
-    umm new_length = builder->string.length + insert_length;
-    if (new_length >= builder->capacity)
-    {
-        umm new_capacity = builder->capacity;
-        if (!new_capacity) new_capacity = 64;
-
-        // growth factor of 1.5
-        do new_capacity = new_capacity + (new_capacity >> 1);
-        while (new_length >= new_capacity);
-
-        u8* new_string = (u8*) malloc(new_capacity);
-        if (builder->string.data)
-        {
-            copy(new_string, builder->string.data, builder->string.length);
-            free(builder->string.data);
-        }
-
-        builder->string.data = new_string;
-        builder->capacity = new_capacity;
-    }
-}
-
-
-void append(String_Builder* builder, const void* data, umm length)
-{
-    maybe_resize(builder, length);
-    copy(builder->string.data + builder->string.length, data, length);
-    builder->string.length += length;
-    builder->string.data[builder->string.length] = 0;
-}
-
-
-void insert(String_Builder* builder, umm at_offset, const void* data, umm length)
-{
-    maybe_resize(builder, length);
-
-    umm string_length = builder->string.length;
-    DebugAssert(at_offset <= string_length);
-    builder->string.length += length;
-
-    u8* from = builder->string.data + at_offset;
-    u8* to = from + length;
-    umm move_size = string_length - at_offset + 1;
-
-    move(to, from, move_size);
-    copy(from, data, length);
-}
-
-
-void remove(String_Builder* builder, umm at_offset, umm length)
-{
-    umm string_length = builder->string.length;
-    DebugAssert(at_offset <= string_length);
-    DebugAssert(at_offset + length <= string_length);
-    builder->string.length -= length;
-
-    u8* to = builder->string.data + at_offset;
-    u8* from = to + length;
-    umm move_size = string_length - at_offset - length + 1;
-    move(to, from, move_size);
-}
\ No newline at end of file
+#include "common.h"
+#include "simd.h"
+
+#include <stdlib.h>
+
+
+/*
+ *
+ * -- implementation of common.h subitems that need .cpp implementation
+ *
+ */
+
+
+//
+//
+// -- temporary memory
+//
+//
+
+Region temporary_memory = {};
+
+
+
+
+//
+//
+// -- string utility
+//
+//
+
+//
+// Memory, character and C-style string utilities.
+//
+
+
+// memcpy and memmove don't allow NULL even with a zero length, callers with empty data do.
+void copy(void* to, const void* from, umm length)
+{
+    if (!length) return;
+    memcpy(to, from, length);
+}
+
+void move(void* to, void* from, umm length)
+{
+    if (!length) return;
+    memmove(to, from, length);
+}
+
+void* grow_array(void* array, umm* capacity, umm needed, umm element_size)
+{
+    umm new_capacity = *capacity * 2;
+    if (new_capacity < needed) new_capacity = needed;
+    if (new_capacity < 64)     new_capacity = 64;
+
+    *capacity = new_capacity;
+    return realloc(array, new_capacity * element_size);
+}
+
+bool compare(const void* m1, const void* m2, umm length)
+{
+    return find_mismatch(m1, m2, length) == length;
+}
+
+umm find_mismatch(const void* m1, const void* m2, umm length)
+{
+    const u8* bytes1 = (const u8*) m1;
+    const u8* bytes2 = (const u8*) m2;
+
+    umm i = 0;
+#ifdef SIMD_SSE2
+    for (; i + 16 <= length; i += 16)
+    {
+        __m128i chunk1 = _mm_loadu_si128((const __m128i*)(bytes1 + i));
+        __m128i chunk2 = _mm_loadu_si128((const __m128i*)(bytes2 + i));
+        u32 different = ~(u32) _mm_movemask_epi8(_mm_cmpeq_epi8(chunk1, chunk2)) & 0xFFFF;
+        if (different)
+            return i + count_trailing_zeros64(different);
+    }
+#endif
+
+    for (; i < length; i++)
+        if (bytes1[i] != bytes2[i])
+            return i;
+
+    return length;
+}
+
+
+static String whitespace_chars = " \t\n\r"_s;
+static String slash_chars = "/\\"_s;
+
+bool is_decimal_digit(u8 character)
+{
+    return character >= '0' && character <= '9';
+}
+
+bool is_whitespace(u8 character)
+{
+    if (character == ' ')  return true;
+    if (character == '\t') return true;
+    if (character == '\n') return true;
+    if (character == '\r') return true;
+
+    return false;
+}
+
+
+umm length_of_c_style_string(const char* c_string)
+{
+    umm length = 0;
+    while (c_string[length])
+        length++;
+    return length;
+}
+
+umm length_of_c_style_string(const u16* c_string)
+{
+    umm length = 0;
+    while (c_string[length])
+        length++;
+    return length;
+}
+
+
+//
+// 8-bit strings.
+// When treated as text, UTF-8 encoding is assumed.
+//
+
+
+String make_string(const char* c_string)
+{
+    umm length = length_of_c_style_string(c_string);
+
+    String result;
+    result.length = length;
+    result.data = LK_RegionArray(temp, u8, length);
+
+    copy(result.data, c_string, length);
+
+    return result;
+}
+
+char* make_c_style_string(String string)
+{
+    char* result = LK_RegionArray(temp, char, string.length + 1);
+
+    copy(result, string.data, string.length);
+    result[string.length] = 0;
+
+    return result;
+}
+
+String wrap_string(const char* c_string)
+{
+    String result;
+    result.length = length_of_c_style_string(c_string);
+    result.data = (u8*) c_string;
+    return result;
+}
+
+
+String allocate_string(Region* memory, String string)
+{
+    String result;
+    result.length = string.length;
+    result.data = LK_RegionArray(memory, u8, string.length);
+
+    copy(result.data, string.data, string.length);
+
+    return result;
+}
+
+
+String clone_string(String string)
+{
+    return allocate_string(temp, string);
+}
+
+
+String concatenate(String first, String second, String third, String fourth, String fifth, String sixth)
+{
+    String result;
+    result.length = first.length + second.length + third.length + fourth.length + fifth.length + sixth.length;
+    result.data = LK_RegionArray(temp, u8, result.length);
+
+    u8* write = result.data;
+
+    copy(write, first.data, first.length);
+    write += first.length;
+
+    copy(write, second.data, second.length);
+    write += second.length;
+
+    copy(write, third.data, third.length);
+    write += third.length;
+
+    copy(write, fourth.data, fourth.length);
+    write += fourth.length;
+
+    copy(write, fifth.data, fifth.length);
+    write += fifth.length;
+
+    copy(write, sixth.data, sixth.length);
+    write += sixth.length;
+
+    return result;
+}
+
+
+String substring(String string, umm start_index, umm length)
+{
+    DebugAssert(start_index <= string.length);
+    DebugAssert((start_index + length) <= string.length);
+
+    String result;
+    result.length = length;
+    result.data = string.data + start_index;
+
+    return result;
+}
+
+// concatenates everything from left[0] to right[end]
+String concatenate_adjacent_substrings(String left, String right, String parent)
+{
+    if (left.data == NULL && left.length == 0) // left string can be empty
+        return right;
+
+    DebugAssert(left.data >= parent.data);
+    DebugAssert(right.data + right.length <= parent.data + parent.length);
+
+    String result;
+    result.data = left.data;
+    result.length = left.length + right.length;
+
+    return result;
+}
+
+
+bool operator==(String lhs, String rhs)
+{
+    if (lhs.length != rhs.length)
+        return false;
+    return compare(lhs.data, rhs.data, lhs.length);
+}
+
+bool operator==(String lhs, const char* rhs)
+{
+    umm rhs_length = length_of_c_style_string(rhs);
+    if (lhs.length != rhs_length)
+        return false;
+    return compare(lhs.data, rhs, lhs.length);
+}
+
+bool operator==(const char* lhs, String rhs)
+{
+    umm lhs_length = length_of_c_style_string(lhs);
+    if (lhs_length != rhs.length)
+        return false;
+    return compare(lhs, rhs.data, lhs_length);
+}
+
+
+bool prefix_equals(String string, String prefix)
+{
+    if (string.length < prefix.length)
+        return false;
+
+    return compare(string.data, prefix.data, prefix.length);
+}
+
+bool suffix_equals(String string, String suffix)
+{
+    if (string.length < suffix.length)
+        return false;
+
+    u8* substring = string.data + string.length - suffix.length;
+    return compare(substring, suffix.data, suffix.length);
+}
+
+
+int compare(String lhs, String rhs)
+{
+    umm length = (lhs.length < rhs.length) ? lhs.length : rhs.length;
+    umm mismatch = find_mismatch(lhs.data, rhs.data, length);
+    if (mismatch < length)
+        return (int) lhs.data[mismatch] - (int) rhs.data[mismatch];
+    return (lhs.length > rhs.length) - (lhs.length < rhs.length);
+}
+
+
+static inline bool is_digit(u8 character)
+{
+    return (u8)(character - '0') < 10;
+}
+
+// Skips leading zeros, and returns the significant digits of the number at 'at'.
+static String consume_digit_run(String string, umm* at)
+{
+    umm i = *at;
+    while (i < string.length && string.data[i] == '0')
+        i++;
+
+    umm start = i;
+    while (i < string.length && is_digit(string.data[i]))
+        i++;
+
+    *at = i;
+
+    String digits;
+    digits.length = i - start;
+    digits.data = string.data + start;
+    return digits;
+}
+
+int compare_natural(String lhs, String rhs)
+{
+    umm i = 0;
+    umm j = 0;
+    while (i < lhs.length && j < rhs.length)
+    {
+        u8 a = lhs.data[i];
+        u8 b = rhs.data[j];
+        if (is_digit(a) && is_digit(b))
+        {
+            // Without leading zeros, the number with more digits is bigger.
+            String a_digits = consume_digit_run(lhs, &i);
+            String b_digits = consume_digit_run(rhs, &j);
+            if (a_digits.length != b_digits.length)
+                return (a_digits.length < b_digits.length) ? -1 : 1;
+
+            int result = compare(a_digits, b_digits);
+            if (result)
+                return result;
+            continue;
+        }
+
+        if (a != b)
+            return (int) a - (int) b;
+        i++;
+        j++;
+    }
+
+    if (i < lhs.length) return  1;
+    if (j < rhs.length) return -1;
+
+    // Equal except for leading zeros, like "frame01" and "frame1".
+    return compare(lhs, rhs);
+}
+
+
+umm find_first_occurance(String string, u8 of)
+{
+    for (imm i = 0; i < string.length; i++)
+        if (string[i] == of)
+            return i;
+
+    return NOT_FOUND;
+}
+
+umm find_first_occurance(String string, String of)
+{
+    if (string.length < of.length)
+        return NOT_FOUND;
+
+    for (imm i = 0; i <= string.length - of.length; i++)
+        if (compare(string.data + i, of.data, of.length))
+            return i;
+
+    return NOT_FOUND;
+}
+
+umm find_first_occurance_of_any(String string, String any_of)
+{
+    for (imm i = 0; i < string.length; i++)
+    {
+        u8 c = string[i];
+
+        for (umm j = 0; j < any_of.length; j++)
+        {
+            u8 c2 = any_of[j];
+            if (c == c2)
+                return i;
+        }
+    }
+
+    return NOT_FOUND;
+}
+
+
+umm find_last_occurance(String string, u8 of)
+{
+    for (imm i = string.length - 1; i >= 0; i--)
+        if (string[i] == of)
+            return i;
+
+    return NOT_FOUND;
+}
+
+umm find_last_occurance(String string, String of)
+{
+    if (string.length < of.length)
+        return NOT_FOUND;
+
+    for (imm i = string.length - of.length; i >= 0; i--)
+        if (compare(string.data + i, of.data, of.length))
+            return i;
+
+    return NOT_FOUND;
+}
+
+umm find_last_occurance_of_any(String string, String any_of)
+{
+    for (imm i = string.length - 1; i >= 0; i--)
+    {
+        u8 c = string[i];
+
+        for (umm j = 0; j < any_of.length; j++)
+        {
+            u8 c2 = any_of[j];
+            if (c == c2)
+                return i;
+        }
+    }
+
+    return NOT_FOUND;
+}
+
+
+void replace_all_occurances(String string, u8 what, u8 with_what)
+{
+    for (imm i = string.length - 1; i >= 0; i--)
+        if (string[i] == what)
+            string[i] = with_what;
+}
+
+
+// Slicing by 8: table k gives the CRC of a byte followed by k zero bytes, so 8 bytes are folded in with 8 independent lookups.
+struct Crc32_Tables
+{
+    u32 tables[8][256];
+};
+
+static constexpr Crc32_Tables make_crc32_tables()
+{
+    Crc32_Tables result = {};
+    for (u32 i = 0; i < 256; i++)
+    {
+        u32 crc = i;
+        for (u32 bit = 0; bit < 8; bit++)
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        result.tables[0][i] = crc;
+    }
+
+    for (u32 i = 0; i < 256; i++)
+        for (u32 k = 1; k < 8; k++)
+            result.tables[k][i] = (result.tables[k - 1][i] >> 8) ^ result.tables[0][result.tables[k - 1][i] & 0xFF];
+    return result;
+}
+
+static constexpr Crc32_Tables CRC32_TABLES = make_crc32_tables();
+
+
+#ifdef SIMD_PCLMUL
+
+// Folds 64 bytes at a time with carry-less multiplies, then reduces to 32 bits with Barrett reduction.
+// The constants are powers of x modulo the CRC polynomial, from Intel's "Fast CRC Computation for
+// Generic Polynomials Using PCLMULQDQ Instruction". Length is at least 64 and a multiple of 16.
+static u32 fold_crc32(u32 crc, const u8* at, umm length)
+{
+    const __m128i k1_k2 = _mm_set_epi64x(0x01C6E41596, 0x0154442BD4);
+    const __m128i k3_k4 = _mm_set_epi64x(0x00CCAA009E, 0x01751997D0);
+    const __m128i k5    = _mm_set_epi64x(0,            0x0163CD6124);
+    const __m128i poly  = _mm_set_epi64x(0x01F7011641, 0x01DB710641);
+    const __m128i low32 = _mm_setr_epi32(-1, 0, -1, 0);
+
+    __m128i x1 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(at +  0)), _mm_cvtsi32_si128((int) crc));
+    __m128i x2 = _mm_loadu_si128((const __m128i*)(at + 16));
+    __m128i x3 = _mm_loadu_si128((const __m128i*)(at + 32));
+    __m128i x4 = _mm_loadu_si128((const __m128i*)(at + 48));
+    at += 64;
+    length -= 64;
+
+    for (; length >= 64; at += 64, length -= 64)
+    {
+        __m128i y1 = _mm_clmulepi64_si128(x1, k1_k2, 0x00);
+        __m128i y2 = _mm_clmulepi64_si128(x2, k1_k2, 0x00);
+        __m128i y3 = _mm_clmulepi64_si128(x3, k1_k2, 0x00);
+        __m128i y4 = _mm_clmulepi64_si128(x4, k1_k2, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k1_k2, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, k1_k2, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, k1_k2, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, k1_k2, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, y1), _mm_loadu_si128((const __m128i*)(at +  0)));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, y2), _mm_loadu_si128((const __m128i*)(at + 16)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, y3), _mm_loadu_si128((const __m128i*)(at + 32)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, y4), _mm_loadu_si128((const __m128i*)(at + 48)));
+    }
+
+    // Fold the four lanes into one, then any remaining 16 byte blocks.
+    __m128i rest[3] = { x2, x3, x4 };
+    for (u32 i = 0; i < 3; i++)
+    {
+        __m128i y1 = _mm_clmulepi64_si128(x1, k3_k4, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k3_k4, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, y1), rest[i]);
+    }
+
+    for (; length >= 16; at += 16, length -= 16)
+    {
+        __m128i y1 = _mm_clmulepi64_si128(x1, k3_k4, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k3_k4, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, y1), _mm_loadu_si128((const __m128i*) at));
+    }
+
+    // 128 bits to 64.
+    __m128i y1 = _mm_clmulepi64_si128(x1, k3_k4, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), y1);
+    y1 = _mm_srli_si128(x1, 4);
+    x1 = _mm_xor_si128(_mm_clmulepi64_si128(_mm_and_si128(x1, low32), k5, 0x00), y1);
+
+    // Barrett reduction to 32 bits.
+    __m128i y2 = _mm_clmulepi64_si128(_mm_and_si128(x1, low32), poly, 0x10);
+    y2 = _mm_clmulepi64_si128(_mm_and_si128(y2, low32), poly, 0x00);
+    x1 = _mm_xor_si128(x1, y2);
+    return (u32) _mm_cvtsi128_si32(_mm_srli_si128(x1, 4));
+}
+
+#endif
+
+
+u32 compute_crc32(String data)
+{
+    const u32 (*t)[256] = CRC32_TABLES.tables;
+    const u8* at = data.data;
+    umm length = data.length;
+
+    u32 crc = U32_MAX;
+
+#ifdef SIMD_PCLMUL
+    if (length >= 64)
+    {
+        umm folded = length & ~(umm) 15;
+        crc = fold_crc32(crc, at, folded);
+        at += folded;
+        length -= folded;
+    }
+#endif
+
+    for (; length >= 8; at += 8, length -= 8)
+    {
+        u32 low, high;
+        memcpy(&low, at, 4);
+        memcpy(&high, at + 4, 4);
+        low ^= crc;
+        crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24] ^
+              t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^ t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+    }
+
+    for (; length; at++, length--)
+        crc = (crc >> 8) ^ t[0][(crc ^ *at) & 0xFF];
+
+    return ~crc;
+}
+
+
+//
+// String hashing.
+//
+
+
+u64 hash_string(String string, u64 seed)
+{
+    u8* data = string.data;
+    umm length = string.length;
+
+    u64 hash = seed ^ (length * 0x9E3779B97F4A7C15);
+    umm i = 0;
+    for (; i + 8 <= length; i += 8)
+    {
+        u64 word;
+        memcpy(&word, data + i, 8);
+        hash = mix_hash(hash, word);
+    }
+
+    // The remaining bytes, put together from loads that overlap instead of a byte at a time.
+    umm tail = length - i;
+    u64 word = 0;
+    if (tail && length >= 8)
+    {
+        memcpy(&word, data + length - 8, 8);
+        word >>= (8 - tail) * 8;
+    }
+    else if (tail >= 4)
+    {
+        u32 low, high;
+        memcpy(&low, data, 4);
+        memcpy(&high, data + tail - 4, 4);
+        word = (u64) low | ((u64) high << ((tail - 4) * 8));
+    }
+    else if (tail)
+    {
+        word = (u64) data[0] | ((u64) data[tail / 2] << (tail / 2 * 8)) | ((u64) data[tail - 1] << ((tail - 1) * 8));
+    }
+
+    return finish_hash(mix_hash(hash, word));
+}
+
+
+//
+// String sorting.
+// Multikey quicksort, 8 bytes at a time. The next 8 bytes of each string are cached as a big endian
+// u64 next to its index, so partitioning only looks at the strings when it moves on to the next 8 bytes.
+//
+
+
+struct Sort_Item
+{
+    u64 key;  // 8 bytes of the string from the current depth on, zero padded.
+    u32 index;
+    u32 length;
+};
+
+
+static inline u64 load_sort_key(String string, umm depth)
+{
+    u64 key = 0;
+    if (depth + 8 <= string.length)
+        memcpy(&key, string.data + depth, 8);
+    else if (depth < string.length)
+        memcpy(&key, string.data + depth, string.length - depth);
+    return endian_swap64(key);
+}
+
+static inline void swap_items(Sort_Item* a, Sort_Item* b)
+{
+    Sort_Item temporary = *a;
+    *a = *b;
+    *b = temporary;
+}
+
+
+// 'strings' are what's sorted by. Ties between equal ones are broken by 'originals', if there are any.
+static int compare_sort_items(Sort_Item* a, Sort_Item* b, String* strings, String* originals, umm depth)
+{
+    if (a->key != b->key)
+        return (a->key < b->key) ? -1 : 1;
+
+    // Everything before depth is the same.
+    String a_rest = strings[a->index];
+    String b_rest = strings[b->index];
+    a_rest.data += depth; a_rest.length = (a_rest.length > depth) ? a_rest.length - depth : 0;
+    b_rest.data += depth; b_rest.length = (b_rest.length > depth) ? b_rest.length - depth : 0;
+
+    int result = compare(a_rest, b_rest);
+    if (!result && originals)
+        result = compare(originals[a->index], originals[b->index]);
+    return result;
+}
+
+
+static void sort_items(Sort_Item* items, umm count, String* strings, String* originals, umm depth)
+{
+    while (count > 16)
+    {
+        u64 a = items[0].key;
+        u64 b = items[count / 2].key;
+        u64 c = items[count - 1].key;
+        u64 pivot = (a < b) ? ((b < c) ? b : ((a < c) ? c : a))
+                            : ((a < c) ? a : ((b < c) ? c : b));
+
+        // [0, less) is below the pivot, [less, greater) is equal to it, [greater, count) is above it.
+        umm less = 0;
+        umm greater = count;
+        for (umm i = 0; i < greater;)
+        {
+            u64 key = items[i].key;
+            if (key < pivot)      swap_items(&items[less++], &items[i++]);
+            else if (key > pivot) swap_items(&items[i], &items[--greater]);
+            else                  i++;
+        }
+
+        // The equal ones only differ after these 8 bytes. Those that end within them come first,
+        // shorter ones before longer ones, because the padding compares lower than any byte.
+        Sort_Item* equal = items + less;
+        umm equal_count = greater - less;
+        umm finished = 0;
+        for (umm i = 0; i < equal_count; i++)
+            if (equal[i].length <= depth + 8)
+                swap_items(&equal[finished++], &equal[i]);
+
+        umm group_end = 0;
+        for (umm remaining = 0; remaining <= 8 && group_end < finished; remaining++)
+        {
+            umm group_start = group_end;
+            for (umm i = group_start; i < finished; i++)
+                if (equal[i].length == depth + remaining)
+                    swap_items(&equal[group_end++], &equal[i]);
+
+            // Strings in a group are equal. Order them by the originals instead.
+            umm group_count = group_end - group_start;
+            if (originals && group_count > 1)
+            {
+                Sort_Item* group = equal + group_start;
+                for (umm i = 0; i < group_count; i++)
+                {
+                    group[i].key = load_sort_key(originals[group[i].index], 0);
+                    group[i].length = (u32) originals[group[i].index].length;
+                }
+                sort_items(group, group_count, originals, NULL, 0);
+            }
+        }
+
+        // The rest of the equal ones continue 8 bytes further.
+        Sort_Item* rest = equal + finished;
+        umm rest_count = equal_count - finished;
+        for (umm i = 0; i < rest_count; i++)
+            rest[i].key = load_sort_key(strings[rest[i].index], depth + 8);
+
+        // Recurse into the two smaller partitions and loop on the largest one,
+        // so the recursion is at most log2(count) deep whatever the input.
+        umm above_count = count - greater;
+        if (rest_count >= less && rest_count >= above_count)
+        {
+            sort_items(items, less, strings, originals, depth);
+            sort_items(items + greater, above_count, strings, originals, depth);
+            items = rest;
+            count = rest_count;
+            depth += 8;
+        }
+        else if (less >= above_count)
+        {
+            sort_items(items + greater, above_count, strings, originals, depth);
+            sort_items(rest, rest_count, strings, originals, depth + 8);
+            count = less;
+        }
+        else
+        {
+            sort_items(items, less, strings, originals, depth);
+            sort_items(rest, rest_count, strings, originals, depth + 8);
+            items += greater;
+            count = above_count;
+        }
+    }
+
+    for (umm i = 1; i < count; i++)
+    {
+        Sort_Item item = items[i];
+        umm j = i;
+        for (; j > 0 && compare_sort_items(&item, &items[j - 1], strings, originals, depth) < 0; j--)
+            items[j] = items[j - 1];
+        items[j] = item;
+    }
+}
+
+
+// Indices and lengths are 32 bits, to keep items small.
+static void sort_strings(String* strings, umm count, String* keys)
+{
+    DebugAssert(count <= U32_MAX);
+
+    Sort_Item* items = LK_RegionArray(temp, Sort_Item, count);
+    for (umm i = 0; i < count; i++)
+    {
+        DebugAssert(keys[i].length <= U32_MAX && strings[i].length <= U32_MAX);
+        items[i].key = load_sort_key(keys[i], 0);
+        items[i].index = (u32) i;
+        items[i].length = (u32) keys[i].length;
+    }
+
+    sort_items(items, count, keys, (keys != strings) ? strings : NULL, 0);
+
+    String* sorted = LK_RegionArray(temp, String, count);
+    for (umm i = 0; i < count; i++)
+        sorted[i] = strings[items[i].index];
+    copy(strings, sorted, count * sizeof(String));
+}
+
+
+void sort(String* strings, umm count)
+{
+    if (count < 2)
+        return;
+
+    Scoped_Region_Cursor scope(temp);
+    sort_strings(strings, count, strings);
+}
+
+
+// Rewrites the string so that comparing the bytes gives the natural order. Each run of digits becomes
+// a '0', the number of significant digits, and the significant digits. Comparing '0' to anything that
+// isn't a digit gives the same result as comparing any digit would.
+static String make_natural_sort_key(String string, Region* memory)
+{
+    // At most 3 bytes for each byte, for single digits.
+    u8* start = LK_RegionArray(memory, u8, string.length * 3 + 6);
+    u8* write = start;
+
+    for (umm at = 0; at < string.length;)
+    {
+        if (!is_digit(string.data[at]))
+        {
+            *(write++) = string.data[at++];
+            continue;
+        }
+
+        String digits = consume_digit_run(string, &at);
+        *(write++) = '0';
+        if (digits.length < 0xFF)
+        {
+            *(write++) = (u8) digits.length;
+        }
+        else
+        {
+            u32 length = endian_swap32((u32) digits.length);
+            *(write++) = 0xFF;
+            memcpy(write, &length, 4);
+            write += 4;
+        }
+
+        memcpy(write, digits.data, digits.length);
+        write += digits.length;
+    }
+
+    String key;
+    key.data = start;
+    key.length = write - start;
+    lk_region_resize_in_place(memory, start, string.length * 3 + 6, key.length);
+    return key;
+}
+
+void sort_natural(String* strings, umm count)
+{
+    if (count < 2)
+        return;
+
+    Scoped_Region_Cursor scope(temp);
+
+    String* keys = LK_RegionArray(temp, String, count);
+    for (umm i = 0; i < count; i++)
+        keys[i] = make_natural_sort_key(strings[i], temp);
+
+    sort_strings(strings, count, keys);
+}
+
+
+//
+//
+// Text reading utilities.
+//
+//
+
+
+void consume(String* string, umm amount)
+{
+    DebugAssert(amount <= string->length);
+    string->data += amount;
+    string->length -= amount;
+}
+
+void consume_whitespace(String* string)
+{
+    while (*string && is_whitespace(string->data[0]))
+        consume(string, 1);
+}
+
+umm find_line_ending(String string)
+{
+    umm at = 0;
+    for (; at + 64 <= string.length; at += 64)
+    {
+        Block64 block = load_block64(string.data + at);
+        u64 mask = equal_mask(&block, '\n') | equal_mask(&block, '\r');
+        if (mask)
+            return at + count_trailing_zeros64(mask);
+    }
+
+    for (; at < string.length; at++)
+        if (string.data[at] == '\n' || string.data[at] == '\r')
+            return at;
+
+    return NOT_FOUND;
+}
+
+String consume_line(String* string)
+{
+    consume_whitespace(string);
+
+    umm line_length = find_line_ending(*string);
+    if (line_length == NOT_FOUND)
+        line_length = string->length;
+
+    String line = substring(*string, 0, line_length);
+    consume(string, line_length);
+
+    return line;
+}
+
+String consume_line_preserve_whitespace(String* string)
+{
+    umm line_length = find_line_ending(*string);
+    if (line_length == NOT_FOUND)
+        line_length = string->length;
+
+    String line = substring(*string, 0, line_length);
+    consume(string, line_length);
+
+    // If we've found the line ending, consume it.
+    if (*string)
+    {
+        umm ending_length = 1;
+        if (string->length > 1)
+        {
+            // Handle two-u8 line endings.
+            u8 c1 = string->data[0];
+            u8 c2 = string->data[1];
+            if ((c1 == '\n' && c2 == '\r') ||
+                (c1 == '\r' && c2 == '\n'))
+                ending_length++;
+        }
+        consume(string, ending_length);
+    }
+
+    return line;
+}
+
+String peek_line_preserve_whitespace(String string)
+{
+    umm line_length = find_line_ending(string);
+    if (line_length == NOT_FOUND)
+        line_length = string.length;
+
+    String line = substring(string, 0, line_length);
+    consume(&string, line_length);
+
+    // If we've found the line ending, consume it.
+    if (string)
+    {
+        umm ending_length = 1;
+        if (string.length > 1)
+        {
+            // Handle two-u8 line endings.
+            u8 c1 = string.data[0];
+            u8 c2 = string.data[1];
+            if ((c1 == '\n' && c2 == '\r') ||
+                (c1 == '\r' && c2 == '\n'))
+                ending_length++;
+        }
+        consume(&string, ending_length);
+    }
+
+    return line;
+}
+
+String consume_until(String* string, u8 until_what)
+{
+    consume_whitespace(string);
+
+    umm left_length = find_first_occurance(*string, until_what);
+    if (left_length == NOT_FOUND)
+        left_length = string->length;
+
+    String left = substring(*string, 0, left_length);
+    consume(string, left_length);
+
+    // If we've found the delimiter, consume it.
+    if (*string)
+        consume(string, 1);
+
+    return left;
+}
+
+String consume_until(String* string, String until_what)
+{
+    consume_whitespace(string);
+
+    umm left_length = find_first_occurance(*string, until_what);
+    if (left_length == NOT_FOUND)
+        left_length = string->length;
+
+    String left = substring(*string, 0, left_length);
+    consume(string, left_length);
+
+    // If we've found the delimiter, consume it.
+    if (*string)
+        consume(string, until_what.length);
+
+    return left;
+}
+
+String consume_until_any(String* string, String until_what)
+{
+    consume_whitespace(string);
+
+    umm left_length = find_first_occurance_of_any(*string, until_what);
+    if (left_length == NOT_FOUND)
+        left_length = string->length;
+
+    String left = substring(*string, 0, left_length);
+    consume(string, left_length);
+
+    // If we've found the delimiter, consume it.
+    if (*string)
+        consume(string, 1);
+
+    return left;
+}
+
+String consume_until_whitespace(String* string)
+{
+    return consume_until_any(string, whitespace_chars);
+}
+
+
+String trim(String string)
+{
+    while (string && is_whitespace(string[0]))
+        consume(&string, 1);
+    while (string && is_whitespace(string[string.length - 1]))
+        string.length--;
+    return string;
+}
+
+
+//
+//
+// Number parsing utilities.
+//
+//
+
+
+#include "number_tables.inl"
+
+
+static inline u64 load_u64(const u8* data)
+{
+    u64 value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+// Returns the high 64 bits of the 128-bit product, and stores the low 64 bits to *low.
+static inline u64 multiply_u64(u64 a, u64 b, u64* low)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+    u64 high;
+    *low = _umul128(a, b, &high);
+    return high;
+#elif defined(__SIZEOF_INT128__)
+    unsigned __int128 product = (unsigned __int128) a * b;
+    *low = (u64) product;
+    return (u64)(product >> 64);
+#else
+    u64 a_lo = (u32) a, a_hi = a >> 32;
+    u64 b_lo = (u32) b, b_hi = b >> 32;
+    u64 lo_lo = a_lo * b_lo;
+    u64 hi_lo = a_hi * b_lo;
+    u64 lo_hi = a_lo * b_hi;
+    u64 hi_hi = a_hi * b_hi;
+    u64 cross = (lo_lo >> 32) + (u32) hi_lo + lo_hi;
+    *low = (cross << 32) | (u32) lo_lo;
+    return (hi_lo >> 32) + (cross >> 32) + hi_hi;
+#endif
+}
+
+
+// SWAR digit handling, 8 ASCII digits at a time, as described by Lemire.
+static inline bool is_eight_digits(u64 chunk)
+{
+    return ((chunk & 0xF0F0F0F0F0F0F0F0ull) |
+            (((chunk + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) == 0x3333333333333333ull;
+}
+
+static inline u32 parse_eight_digits(u64 chunk)
+{
+    const u64 mask = 0x000000FF000000FFull;
+    const u64 mul1 = 0x000F424000000064ull;  // 100 + (1000000 << 32)
+    const u64 mul2 = 0x0000271000000001ull;  // 1 + (10000 << 32)
+
+    chunk -= 0x3030303030303030ull;
+    chunk = (chunk * 10) + (chunk >> 8);
+    chunk = (((chunk & mask) * mul1) + (((chunk >> 16) & mask) * mul2)) >> 32;
+    return (u32) chunk;
+}
+
+// Accumulates decimal digits from the start of the string into *value, wrapping on overflow.
+// Returns the number of digits read.
+static umm accumulate_digits(String string, u64* value)
+{
+    u64 result = *value;
+    umm index = 0;
+
+    while (string.length - index >= 8)
+    {
+        u64 chunk = load_u64(string.data + index);
+        if (!is_eight_digits(chunk))
+            break;
+        result = result * 100000000 + parse_eight_digits(chunk);
+        index += 8;
+    }
+
+    while (index < string.length && is_decimal_digit(string.data[index]))
+    {
+        result = result * 10 + (string.data[index] - '0');
+        index++;
+    }
+
+    *value = result;
+    return index;
+}
+
+static umm count_leading_zero_digits(String string)
+{
+    umm index = 0;
+    while (index < string.length && string.data[index] == '0')
+        index++;
+    return index;
+}
+
+// Parses an unsigned decimal magnitude. Returns the number of bytes read, 0 on failure.
+static umm parse_decimal_magnitude(String string, u64* result)
+{
+    umm zeros = count_leading_zero_digits(string);
+    String digits = string;
+    consume(&digits, zeros);
+
+    u64 value = 0;
+    umm digit_count = accumulate_digits(digits, &value);
+    if (!zeros && !digit_count)
+        return 0;
+
+    // 20 digits is the most a u64 can hold, and then only if the first one is 1
+    // and the result didn't wrap around below 10^19.
+    if (digit_count > 20)
+        return 0;
+    if (digit_count == 20 && (digits.data[0] != '1' || value < 10000000000000000000ull))
+        return 0;
+
+    *result = value;
+    return zeros + digit_count;
+}
+
+
+bool parse_u64(String* string, u64* result)
+{
+    String rest = *string;
+    consume_whitespace(&rest);
+
+    if (rest && rest.data[0] == '+')
+        consume(&rest, 1);
+
+    umm length = parse_decimal_magnitude(rest, result);
+    if (!length)
+        return false;
+
+    consume(&rest, length);
+    *string = rest;
+    return true;
+}
+
+bool parse_i64(String* string, i64* result)
+{
+    String rest = *string;
+    consume_whitespace(&rest);
+
+    bool negative = false;
+    if (rest && (rest.data[0] == '+' || rest.data[0] == '-'))
+    {
+        negative = rest.data[0] == '-';
+        consume(&rest, 1);
+    }
+
+    u64 magnitude;
+    umm length = parse_decimal_magnitude(rest, &magnitude);
+    if (!length)
+        return false;
+
+    u64 limit = (u64) 1 << 63;
+    if (!negative) limit--;
+    if (magnitude > limit)
+        return false;
+
+    *result = negative ? (i64)(0 - magnitude) : (i64) magnitude;
+
+    consume(&rest, length);
+    *string = rest;
+    return true;
+}
+
+static inline u32 hex_digit_value(u8 character)
+{
+    if (character >= '0' && character <= '9') return character - '0';
+    if (character >= 'a' && character <= 'f') return character - 'a' + 10;
+    if (character >= 'A' && character <= 'F') return character - 'A' + 10;
+    return 16;
+}
+
+bool parse_hex_u64(String* string, u64* result)
+{
+    String rest = *string;
+    consume_whitespace(&rest);
+
+    if (rest.length > 2 && rest.data[0] == '0' && (rest.data[1] == 'x' || rest.data[1] == 'X') &&
+        hex_digit_value(rest.data[2]) < 16)
+        consume(&rest, 2);
+
+    umm zeros = count_leading_zero_digits(rest);
+    consume(&rest, zeros);
+
+    u64 value = 0;
+    umm digit_count = 0;
+    while (digit_count < rest.length)
+    {
+        u32 digit = hex_digit_value(rest.data[digit_count]);
+        if (digit >= 16)
+            break;
+        value = (value << 4) | digit;
+        digit_count++;
+    }
+
+    if (!zeros && !digit_count)
+        return false;
+    if (digit_count > 16)
+        return false;
+
+    consume(&rest, digit_count);
+    *string = rest;
+    *result = value;
+    return true;
+}
+
+
+//
+// Floats are parsed with the Eisel-Lemire algorithm, as described by Lemire in
+// "Number Parsing at a Gigabyte per Second", and follow the fast_float implementation.
+// The rare inputs it can't decide on (ambiguous rounding, or more than 19 significant digits
+// whose truncation matters) fall back to exact decimal arithmetic. Nothing depends on the C locale,
+// and nothing is copied or allocated.
+//
+
+
+struct Float_Format
+{
+    i32 mantissa_explicit_bits;
+    i32 minimum_exponent;
+    i32 infinite_power;
+    i32 smallest_power_of_ten;
+    i32 largest_power_of_ten;
+    i32 min_exponent_round_to_even;
+    i32 max_exponent_round_to_even;
+    i32 max_exponent_fast_path;
+};
+
+static constexpr Float_Format F64_FORMAT = { 52, -1023, 0x7FF, -342, 308,  -4, 23, 22 };
+static constexpr Float_Format F32_FORMAT = { 23,  -127,  0xFF,  -65,  38, -17, 10, 10 };
+
+
+struct Decimal_Number
+{
+    bool negative;
+    bool too_many_digits;  // mantissa holds only the first 19 significant digits
+    u64  mantissa;
+    i64  exponent;
+    umm  length;           // bytes of the source string that make up the number
+};
+
+static bool scan_decimal_number(String string, Decimal_Number* number)
+{
+    String rest = string;
+    ZeroStruct(number);
+
+    if (rest && (rest.data[0] == '+' || rest.data[0] == '-'))
+    {
+        number->negative = rest.data[0] == '-';
+        consume(&rest, 1);
+    }
+
+    u64 mantissa = 0;
+    String integer_part = rest;
+    integer_part.length = accumulate_digits(rest, &mantissa);
+    consume(&rest, integer_part.length);
+
+    String fraction_part = {};
+    if (rest && rest.data[0] == '.')
+    {
+        consume(&rest, 1);
+        fraction_part = rest;
+        fraction_part.length = accumulate_digits(rest, &mantissa);
+        consume(&rest, fraction_part.length);
+    }
+
+    i64 digit_count = integer_part.length + fraction_part.length;
+    if (!digit_count)
+        return false;
+
+    i64 explicit_exponent = 0;
+    if (rest && (rest.data[0] == 'e' || rest.data[0] == 'E'))
+    {
+        // If there are no exponent digits, the 'e' isn't a part of the number.
+        String exponent_string = rest;
+        consume(&exponent_string, 1);
+
+        bool negative_exponent = false;
+        if (exponent_string && (exponent_string.data[0] == '+' || exponent_string.data[0] == '-'))
+        {
+            negative_exponent = exponent_string.data[0] == '-';
+            consume(&exponent_string, 1);
+        }
+
+        if (exponent_string && is_decimal_digit(exponent_string.data[0]))
+        {
+            while (exponent_string && is_decimal_digit(exponent_string.data[0]))
+            {
+                // Saturate, anything this large is zero or infinity anyway.
+                if (explicit_exponent < 0x10000000)
+                    explicit_exponent = explicit_exponent * 10 + (exponent_string.data[0] - '0');
+                consume(&exponent_string, 1);
+            }
+
+            if (negative_exponent)
+                explicit_exponent = -explicit_exponent;
+            rest = exponent_string;
+        }
+    }
+
+    number->length   = rest.data - string.data;
+    number->mantissa = mantissa;
+    number->exponent = explicit_exponent - (i64) fraction_part.length;
+
+    if (digit_count > 19)
+    {
+        // Leading zeros (also those after the decimal point) aren't significant.
+        u8* end = string.data + number->length;
+        u8* leading = integer_part.length ? integer_part.data : fraction_part.data;
+        for (u8* c = leading; c < end; c++)
+        {
+            if (*c == '0') digit_count--;
+            else if (*c != '.') break;
+        }
+
+        if (digit_count > 19)
+        {
+            // Keep only the first 19 significant digits, and let compute_float decide whether
+            // the rest could have changed the outcome.
+            number->too_many_digits = true;
+
+            const u64 MIN_NINETEEN_DIGIT_INTEGER = 1000000000000000000ull;
+            mantissa = 0;
+
+            umm index = 0;
+            while (mantissa < MIN_NINETEEN_DIGIT_INTEGER && index < integer_part.length)
+                mantissa = mantissa * 10 + (integer_part.data[index++] - '0');
+
+            if (mantissa >= MIN_NINETEEN_DIGIT_INTEGER)
+            {
+                number->exponent = (i64)(integer_part.length - index) + explicit_exponent;
+            }
+            else
+            {
+                index = 0;
+                while (mantissa < MIN_NINETEEN_DIGIT_INTEGER && index < fraction_part.length)
+                    mantissa = mantissa * 10 + (fraction_part.data[index++] - '0');
+                number->exponent = explicit_exponent - (i64) index;
+            }
+
+            number->mantissa = mantissa;
+        }
+    }
+
+    return true;
+}
+
+
+struct Adjusted_Mantissa
+{
+    u64 mantissa;
+    i32 power2;  // Biased exponent. Negative when the result couldn't be decided.
+};
+
+static Adjusted_Mantissa compute_float(const Float_Format* format, i64 q, u64 w)
+{
+    Adjusted_Mantissa answer;
+
+    if (w == 0 || q < format->smallest_power_of_ten)
+    {
+        answer.mantissa = 0;
+        answer.power2 = 0;
+        return answer;
+    }
+
+    if (q > format->largest_power_of_ten)
+    {
+        answer.mantissa = 0;
+        answer.power2 = format->infinite_power;
+        return answer;
+    }
+
+    i32 lz = count_leading_zeros64(w);
+    w <<= lz;
+
+    // Multiply by the 128-bit approximation of 5^q, but only go for the low half of
+    // the power when the high half leaves the result uncertain.
+    const u64* power = POWER_OF_FIVE_128 + 2 * (q - POWER_OF_FIVE_128_MIN_EXPONENT);
+    u64 precision_mask = 0xFFFFFFFFFFFFFFFFull >> (format->mantissa_explicit_bits + 3);
+
+    u64 low;
+    u64 high = multiply_u64(w, power[0], &low);
+    if ((high & precision_mask) == precision_mask)
+    {
+        u64 second_low;
+        u64 second_high = multiply_u64(w, power[1], &second_low);
+        low += second_high;
+        if (second_high > low)
+            high++;
+    }
+
+    if (low == 0xFFFFFFFFFFFFFFFFull)
+    {
+        // For q in [-27, 55] the product is exact, otherwise we can't tell which way to round.
+        if (q < -27 || q > 55)
+        {
+            answer.mantissa = 0;
+            answer.power2 = -1;
+            return answer;
+        }
+    }
+
+    i32 upper_bit = (i32)(high >> 63);
+    i32 shift = upper_bit + 64 - format->mantissa_explicit_bits - 3;
+
+    answer.mantissa = high >> shift;
+    answer.power2 = (i32)((((152170 + 65536) * q) >> 16) + 63) + upper_bit - lz - format->minimum_exponent;
+
+    if (answer.power2 <= 0)
+    {
+        // Subnormal.
+        if (-answer.power2 + 1 >= 64)
+        {
+            answer.mantissa = 0;
+            answer.power2 = 0;
+            return answer;
+        }
+
+        answer.mantissa >>= -answer.power2 + 1;
+        answer.mantissa += (answer.mantissa & 1);
+        answer.mantissa >>= 1;
+        answer.power2 = (answer.mantissa < ((u64) 1 << format->mantissa_explicit_bits)) ? 0 : 1;
+        return answer;
+    }
+
+    // Exactly halfway between two floats, round to even.
+    if (low <= 1 && (answer.mantissa & 3) == 1 &&
+        q >= format->min_exponent_round_to_even &&
+        q <= format->max_exponent_round_to_even)
+    {
+        if ((answer.mantissa << shift) == high)
+            answer.mantissa &= ~(u64) 1;
+    }
+
+    answer.mantissa += (answer.mantissa & 1);
+    answer.mantissa >>= 1;
+    if (answer.mantissa >= ((u64) 2 << format->mantissa_explicit_bits))
+    {
+        answer.mantissa = (u64) 1 << format->mantissa_explicit_bits;
+        answer.power2++;
+    }
+
+    answer.mantissa &= ~((u64) 1 << format->mantissa_explicit_bits);
+    if (answer.power2 >= format->infinite_power)
+    {
+        answer.mantissa = 0;
+        answer.power2 = format->infinite_power;
+    }
+
+    return answer;
+}
+
+// Returns the float bits (without the sign), or false if the slow path is needed.
+static bool decimal_to_float_bits(const Float_Format* format, Decimal_Number* number, u64* bits)
+{
+    Adjusted_Mantissa am = compute_float(format, number->exponent, number->mantissa);
+    if (am.power2 < 0)
+        return false;
+
+    if (number->too_many_digits)
+    {
+        // The truncated digits might have pushed the value over to the next float.
+        Adjusted_Mantissa am_up = compute_float(format, number->exponent, number->mantissa + 1);
+        if (am_up.power2 != am.power2 || am_up.mantissa != am.mantissa)
+            return false;
+    }
+
+    *bits = am.mantissa | ((u64) am.power2 << format->mantissa_explicit_bits);
+    return true;
+}
+
+static umm scan_special_float(String string, bool* negative, bool* is_nan)
+{
+    String rest = string;
+    *negative = false;
+    if (rest && (rest.data[0] == '+' || rest.data[0] == '-'))
+    {
+        *negative = rest.data[0] == '-';
+        consume(&rest, 1);
+    }
+
+    auto starts_with_ignoring_case = [](String string, String lowercase_prefix)
+    {
+        if (string.length < lowercase_prefix.length)
+            return false;
+        for (umm i = 0; i < lowercase_prefix.length; i++)
+            if ((string.data[i] | 0x20) != lowercase_prefix.data[i])
+                return false;
+        return true;
+    };
+
+    umm sign_length = string.length - rest.length;
+    if (starts_with_ignoring_case(rest, "nan"_s))      { *is_nan = true;  return sign_length + 3; }
+    if (starts_with_ignoring_case(rest, "infinity"_s)) { *is_nan = false; return sign_length + 8; }
+    if (starts_with_ignoring_case(rest, "inf"_s))      { *is_nan = false; return sign_length + 3; }
+    return 0;
+}
+
+// The slow path, for inputs the fast paths can't decide on. This is the simple decimal conversion
+// fast_float used before its big integer version: the digits are kept as a decimal number and
+// shifted by powers of two until the value is in [1/2, 1), so the binary exponent is known,
+// and then shifted by the mantissa width and rounded. 768 digits are enough to decide every
+// halfway case, the rest only matter through whether any of them is non-zero.
+
+constexpr u32 BIG_DECIMAL_MAX_DIGITS = 768;
+constexpr i32 BIG_DECIMAL_POINT_RANGE = 2047;
+
+struct Big_Decimal
+{
+    u32  digit_count;
+    i32  decimal_point;  // The value is 0.digits * 10^decimal_point.
+    bool truncated;      // Non-zero digits after the first BIG_DECIMAL_MAX_DIGITS were dropped.
+    u8   digits[BIG_DECIMAL_MAX_DIGITS + 19];  // Room for the digits a left shift adds.
+};
+
+static void trim_trailing_zeros(Big_Decimal* d)
+{
+    while (d->digit_count && d->digits[d->digit_count - 1] == 0)
+        d->digit_count--;
+}
+
+// 'number' is what scan_decimal_number accepted.
+static void scan_big_decimal(String number, Big_Decimal* d)
+{
+    d->digit_count = 0;
+    d->decimal_point = 0;
+    d->truncated = false;
+
+    String rest = number;
+    if (rest.data[0] == '+' || rest.data[0] == '-')
+        consume(&rest, 1);
+
+    bool after_point = false;
+    while (rest && (is_decimal_digit(rest.data[0]) || rest.data[0] == '.'))
+    {
+        u8 c = rest.data[0];
+        consume(&rest, 1);
+
+        if (c == '.')
+        {
+            after_point = true;
+            continue;
+        }
+
+        if (c == '0' && !d->digit_count && !d->truncated)
+        {
+            // Leading zeros after the point move it, before the point they mean nothing.
+            if (after_point)
+                d->decimal_point--;
+            continue;
+        }
+
+        if (d->digit_count < BIG_DECIMAL_MAX_DIGITS)
+            d->digits[d->digit_count++] = c - '0';
+        else if (c != '0')
+            d->truncated = true;
+
+        if (!after_point)
+            d->decimal_point++;
+    }
+
+    if (rest)
+    {
+        // The exponent. It's saturated, anything past the range is zero or infinity anyway.
+        consume(&rest, 1);
+        bool negative = rest.data[0] == '-';
+        if (rest.data[0] == '+' || rest.data[0] == '-')
+            consume(&rest, 1);
+
+        i32 exponent = 0;
+        for (; rest; consume(&rest, 1))
+            if (exponent < 0x1000000)
+                exponent = exponent * 10 + (rest.data[0] - '0');
+
+        d->decimal_point += negative ? -exponent : exponent;
+    }
+
+    trim_trailing_zeros(d);
+}
+
+static void shift_big_decimal_right(Big_Decimal* d, u32 shift)
+{
+    u32 read = 0;
+    u32 write = 0;
+    u64 n = 0;
+
+    while ((n >> shift) == 0)
+    {
+        if (read < d->digit_count)
+        {
+            n = n * 10 + d->digits[read++];
+        }
+        else if (n == 0)
+        {
+            return;
+        }
+        else
+        {
+            while ((n >> shift) == 0)
+            {
+                n *= 10;
+                read++;
+            }
+            break;
+        }
+    }
+
+    d->decimal_point -= (i32) read - 1;
+    if (d->decimal_point < -BIG_DECIMAL_POINT_RANGE)
+    {
+        d->digit_count = 0;
+        d->decimal_point = 0;
+        d->truncated = false;
+        return;
+    }
+
+    u64 mask = ((u64) 1 << shift) - 1;
+    while (read < d->digit_count)
+    {
+        u8 digit = (u8)(n >> shift);
+        n = (n & mask) * 10 + d->digits[read++];
+        d->digits[write++] = digit;
+    }
+
+    while (n)
+    {
+        u8 digit = (u8)(n >> shift);
+        n = (n & mask) * 10;
+        if (write < BIG_DECIMAL_MAX_DIGITS)
+            d->digits[write++] = digit;
+        else if (digit)
+            d->truncated = true;
+    }
+
+    d->digit_count = write;
+    trim_trailing_zeros(d);
+}
+
+static void shift_big_decimal_left(Big_Decimal* d, u32 shift)
+{
+    if (!d->digit_count)
+        return;
+
+    // Shifting by at most 60 adds at most 19 digits, so write them with that offset
+    // and move the result down after.
+    i32 write = (i32) d->digit_count - 1 + 19;
+    u64 n = 0;
+    for (i32 read = (i32) d->digit_count - 1; read >= 0; read--)
+    {
+        n += (u64) d->digits[read] << shift;
+        d->digits[write--] = (u8)(n % 10);
+        n /= 10;
+    }
+    while (n)
+    {
+        d->digits[write--] = (u8)(n % 10);
+        n /= 10;
+    }
+
+    u32 first = (u32)(write + 1);
+    u32 new_digit_count = 19 - first;
+    u32 count = d->digit_count + new_digit_count;
+    if (count > BIG_DECIMAL_MAX_DIGITS)
+    {
+        for (u32 i = first + BIG_DECIMAL_MAX_DIGITS; i < first + count; i++)
+            if (d->digits[i])
+                d->truncated = true;
+        count = BIG_DECIMAL_MAX_DIGITS;
+    }
+
+    memmove(d->digits, d->digits + first, count);
+    d->digit_count = count;
+    d->decimal_point += new_digit_count;
+    trim_trailing_zeros(d);
+}
+
+// The integer part, rounded to nearest even.
+static u64 round_big_decimal(Big_Decimal* d)
+{
+    if (!d->digit_count || d->decimal_point < 0)
+        return 0;
+    if (d->decimal_point > 18)
+        return 0xFFFFFFFFFFFFFFFFull;
+
+    u32 point = (u32) d->decimal_point;
+    u64 n = 0;
+    for (u32 i = 0; i < point; i++)
+        n = n * 10 + (i < d->digit_count ? d->digits[i] : 0);
+
+    bool round_up = false;
+    if (point < d->digit_count)
+    {
+        round_up = d->digits[point] >= 5;
+        if (d->digits[point] == 5 && point + 1 == d->digit_count)
+            round_up = d->truncated || (point > 0 && (d->digits[point - 1] & 1));
+    }
+
+    return n + round_up;
+}
+
+// Returns the float bits without the sign.
+static u64 parse_float_bits_slow(const Float_Format* format, String number)
+{
+    Big_Decimal d;
+    scan_big_decimal(number, &d);
+
+    u64 infinity = (u64) format->infinite_power << format->mantissa_explicit_bits;
+    if (!d.digit_count || d.decimal_point < -324)
+        return 0;
+    if (d.decimal_point >= 310)
+        return infinity;
+
+    // Shifts that take 'n' decimal digits off or on, at most 60.
+    static constexpr u8 SHIFTS[] = { 0, 3, 6, 9, 13, 16, 19, 23, 26, 29, 33, 36, 39, 43, 46, 49, 53, 56, 59 };
+    constexpr u32 MAX_SHIFT = 60;
+
+    i32 exponent = 0;
+    while (d.decimal_point > 0)
+    {
+        u32 n = (u32) d.decimal_point;
+        u32 shift = n < ArrayCount(SHIFTS) ? SHIFTS[n] : MAX_SHIFT;
+        shift_big_decimal_right(&d, shift);
+        if (d.decimal_point < -BIG_DECIMAL_POINT_RANGE)
+            return 0;
+        exponent += shift;
+    }
+
+    while (d.decimal_point <= 0)
+    {
+        u32 shift;
+        if (d.decimal_point == 0)
+        {
+            if (d.digits[0] >= 5)
+                break;
+            shift = d.digits[0] < 2 ? 2 : 1;
+        }
+        else
+        {
+            u32 n = (u32) -d.decimal_point;
+            shift = n < ArrayCount(SHIFTS) ? SHIFTS[n] : MAX_SHIFT;
+        }
+
+        shift_big_decimal_left(&d, shift);
+        if (d.decimal_point > BIG_DECIMAL_POINT_RANGE)
+            return infinity;
+        exponent -= shift;
+    }
+
+    // Now in [1/2, 1), floats are in [1, 2).
+    exponent--;
+
+    while (exponent < format->minimum_exponent + 1)
+    {
+        u32 shift = (u32)(format->minimum_exponent + 1 - exponent);
+        if (shift > MAX_SHIFT)
+            shift = MAX_SHIFT;
+        shift_big_decimal_right(&d, shift);
+        exponent += shift;
+    }
+
+    if (exponent - format->minimum_exponent >= format->infinite_power)
+        return infinity;
+
+    u32 mantissa_bits = format->mantissa_explicit_bits + 1;
+    shift_big_decimal_left(&d, mantissa_bits);
+    u64 mantissa = round_big_decimal(&d);
+
+    // Rounding up can carry into one more bit.
+    if (mantissa >= ((u64) 1 << mantissa_bits))
+    {
+        shift_big_decimal_right(&d, 1);
+        exponent++;
+        mantissa = round_big_decimal(&d);
+        if (exponent - format->minimum_exponent >= format->infinite_power)
+            return infinity;
+    }
+
+    i32 power2 = exponent - format->minimum_exponent;
+    if (mantissa < ((u64) 1 << format->mantissa_explicit_bits))
+        power2--;  // Subnormal.
+
+    mantissa &= ((u64) 1 << format->mantissa_explicit_bits) - 1;
+    return mantissa | ((u64) power2 << format->mantissa_explicit_bits);
+}
+
+
+bool parse_f64(String* string, f64* result)
+{
+    String rest = *string;
+    consume_whitespace(&rest);
+
+    Decimal_Number number;
+    if (!scan_decimal_number(rest, &number))
+    {
+        bool negative, is_nan;
+        umm length = scan_special_float(rest, &negative, &is_nan);
+        if (!length)
+            return false;
+
+        u64 bits = is_nan ? 0x7FF8000000000000ull : 0x7FF0000000000000ull;
+        if (negative) bits |= (u64) 1 << 63;
+        memcpy(result, &bits, sizeof(bits));
+
+        consume(&rest, length);
+        *string = rest;
+        return true;
+    }
+
+    static constexpr f64 POWERS_OF_TEN[] =
+    {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    f64 value;
+    u64 bits;
+    if (!number.too_many_digits &&
+        number.exponent >= -F64_FORMAT.max_exponent_fast_path &&
+        number.exponent <=  F64_FORMAT.max_exponent_fast_path &&
+        number.mantissa <= ((u64) 2 << F64_FORMAT.mantissa_explicit_bits))
+    {
+        // Clinger's fast path: both the mantissa and the power of ten are exact doubles,
+        // so a single IEEE operation rounds correctly.
+        value = (f64) number.mantissa;
+        if (number.exponent < 0) value /= POWERS_OF_TEN[-number.exponent];
+        else                     value *= POWERS_OF_TEN[ number.exponent];
+        if (number.negative) value = -value;
+    }
+    else if (decimal_to_float_bits(&F64_FORMAT, &number, &bits))
+    {
+        if (number.negative) bits |= (u64) 1 << 63;
+        memcpy(&value, &bits, sizeof(bits));
+    }
+    else
+    {
+        bits = parse_float_bits_slow(&F64_FORMAT, substring(rest, 0, number.length));
+        if (number.negative) bits |= (u64) 1 << 63;
+        memcpy(&value, &bits, sizeof(bits));
+    }
+
+    *result = value;
+    consume(&rest, number.length);
+    *string = rest;
+    return true;
+}
+
+bool parse_f32(String* string, f32* result)
+{
+    String rest = *string;
+    consume_whitespace(&rest);
+
+    Decimal_Number number;
+    if (!scan_decimal_number(rest, &number))
+    {
+        bool negative, is_nan;
+        umm length = scan_special_float(rest, &negative, &is_nan);
+        if (!length)
+            return false;
+
+        u32 bits = is_nan ? 0x7FC00000 : 0x7F800000;
+        if (negative) bits |= (u32) 1 << 31;
+        memcpy(result, &bits, sizeof(bits));
+
+        consume(&rest, length);
+        *string = rest;
+        return true;
+    }
+
+    static constexpr f32 POWERS_OF_TEN[] =
+    {
+        1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+    };
+
+    f32 value;
+    u64 bits;
+    if (!number.too_many_digits &&
+        number.exponent >= -F32_FORMAT.max_exponent_fast_path &&
+        number.exponent <=  F32_FORMAT.max_exponent_fast_path &&
+        number.mantissa <= ((u64) 2 << F32_FORMAT.mantissa_explicit_bits))
+    {
+        value = (f32) number.mantissa;
+        if (number.exponent < 0) value /= POWERS_OF_TEN[-number.exponent];
+        else                     value *= POWERS_OF_TEN[ number.exponent];
+        if (number.negative) value = -value;
+    }
+    else if (decimal_to_float_bits(&F32_FORMAT, &number, &bits))
+    {
+        u32 bits32 = (u32) bits;
+        if (number.negative) bits32 |= (u32) 1 << 31;
+        memcpy(&value, &bits32, sizeof(bits32));
+    }
+    else
+    {
+        u32 bits32 = (u32) parse_float_bits_slow(&F32_FORMAT, substring(rest, 0, number.length));
+        if (number.negative) bits32 |= (u32) 1 << 31;
+        memcpy(&value, &bits32, sizeof(bits32));
+    }
+
+    *result = value;
+    consume(&rest, number.length);
+    *string = rest;
+    return true;
+}
+
+
+#define ParseWholeString(parse, string, result)     \
+{                                                   \
+    String rest = trim(string);                     \
+    if (!parse(&rest, result)) return false;        \
+    return rest.length == 0;                        \
+}
+
+bool parse_u64    (String string, u64* result) ParseWholeString(parse_u64,     string, result)
+bool parse_i64    (String string, i64* result) ParseWholeString(parse_i64,     string, result)
+bool parse_hex_u64(String string, u64* result) ParseWholeString(parse_hex_u64, string, result)
+bool parse_f32    (String string, f32* result) ParseWholeString(parse_f32,     string, result)
+bool parse_f64    (String string, f64* result) ParseWholeString(parse_f64,     string, result)
+
+#undef ParseWholeString
+
+
+//
+//
+// Binary reading utilities.
+//
+//
+
+
+bool read_bytes(String* string, void* result, umm count)
+{
+    if (string->length < count)
+        return false;
+
+    copy(result, string->data, count);
+    consume(string, count);
+    return true;
+}
+
+
+bool read_u8 (String* string, u8*  result) { return read_bytes(string, result, 1); }
+bool read_u16(String* string, u16* result) { return read_bytes(string, result, 2); }
+bool read_u32(String* string, u32* result) { return read_bytes(string, result, 4); }
+bool read_u64(String* string, u64* result) { return read_bytes(string, result, 8); }
+
+bool read_i8 (String* string, i8*  result) { return read_bytes(string, result, 1); }
+bool read_i16(String* string, i16* result) { return read_bytes(string, result, 2); }
+bool read_i32(String* string, i32* result) { return read_bytes(string, result, 4); }
+bool read_i64(String* string, i64* result) { return read_bytes(string, result, 8); }
+
+
+#ifdef BIG_ENDIAN
+#error "Go away, we don't like you!"
+#endif
+
+bool read_u16le(String* string, u16* result) { return read_bytes(string, result, 2); }
+bool read_u32le(String* string, u32* result) { return read_bytes(string, result, 4); }
+bool read_u64le(String* string, u64* result) { return read_bytes(string, result, 8); }
+
+bool read_u16be(String* string, u16* result) { Defer(*result = endian_swap16(*result)); return read_bytes(string, result, 2); }
+bool read_u32be(String* string, u32* result) { Defer(*result = endian_swap32(*result)); return read_bytes(string, result, 4); }
+bool read_u64be(String* string, u64* result) { Defer(*result = endian_swap64(*result)); return read_bytes(string, result, 8); }
+
+bool read_i16le(String* string, i16* result) { return read_bytes(string, result, 2); }
+bool read_i32le(String* string, i32* result) { return read_bytes(string, result, 4); }
+bool read_i64le(String* string, i64* result) { return read_bytes(string, result, 8); }
+
+bool read_i16be(String* string, i16* result) { Defer(*result = (i16) endian_swap16((u16) *result)); return read_bytes(string, result, 2); }
+bool read_i32be(String* string, i32* result) { Defer(*result = (i32) endian_swap32((u32) *result)); return read_bytes(string, result, 4); }
+bool read_i64be(String* string, i64* result) { Defer(*result = (i64) endian_swap64((u64) *result)); return read_bytes(string, result, 8); }
+
+
+static bool read_array(String* string, void* result, umm count, umm element_size)
+{
+    if (count > string->length / element_size)
+        return false;
+
+    copy(result, string->data, count * element_size);
+    consume(string, count * element_size);
+    return true;
+}
+
+static bool view_array(String* string, const void** result, umm count, umm element_size)
+{
+    if (count > string->length / element_size)
+        return false;
+    if ((umm) string->data % element_size)
+        return false;
+
+    *result = string->data;
+    consume(string, count * element_size);
+    return true;
+}
+
+
+// Byte swapping copies. SSE2 has no byte shuffle, but swapping the bytes in every 16-bit lane
+// with shifts and then reordering the lanes with word shuffles does the same.
+static void copy_swapped_u16(u16* target, const u8* source, umm count)
+{
+    umm i = 0;
+#ifdef SIMD_SSE2
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i value = _mm_loadu_si128((const __m128i*)(source + i * 2));
+        value = _mm_or_si128(_mm_slli_epi16(value, 8), _mm_srli_epi16(value, 8));
+        _mm_storeu_si128((__m128i*)(target + i), value);
+    }
+#endif
+    for (; i < count; i++)
+    {
+        u16 value;
+        copy(&value, source + i * 2, 2);
+        target[i] = endian_swap16(value);
+    }
+}
+
+static void copy_swapped_u32(u32* target, const u8* source, umm count)
+{
+    umm i = 0;
+#ifdef SIMD_SSE2
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i value = _mm_loadu_si128((const __m128i*)(source + i * 4));
+        value = _mm_or_si128(_mm_slli_epi16(value, 8), _mm_srli_epi16(value, 8));
+        value = _mm_shufflelo_epi16(value, _MM_SHUFFLE(2, 3, 0, 1));
+        value = _mm_shufflehi_epi16(value, _MM_SHUFFLE(2, 3, 0, 1));
+        _mm_storeu_si128((__m128i*)(target + i), value);
+    }
+#endif
+    for (; i < count; i++)
+    {
+        u32 value;
+        copy(&value, source + i * 4, 4);
+        target[i] = endian_swap32(value);
+    }
+}
+
+static void copy_swapped_u64(u64* target, const u8* source, umm count)
+{
+    umm i = 0;
+#ifdef SIMD_SSE2
+    for (; i + 2 <= count; i += 2)
+    {
+        __m128i value = _mm_loadu_si128((const __m128i*)(source + i * 8));
+        value = _mm_or_si128(_mm_slli_epi16(value, 8), _mm_srli_epi16(value, 8));
+        value = _mm_shufflelo_epi16(value, _MM_SHUFFLE(0, 1, 2, 3));
+        value = _mm_shufflehi_epi16(value, _MM_SHUFFLE(0, 1, 2, 3));
+        _mm_storeu_si128((__m128i*)(target + i), value);
+    }
+#endif
+    for (; i < count; i++)
+    {
+        u64 value;
+        copy(&value, source + i * 8, 8);
+        target[i] = endian_swap64(value);
+    }
+}
+
+
+bool read_array_u16le(String* string, u16* result, umm count) { return read_array(string, result, count, 2); }
+bool read_array_u32le(String* string, u32* result, umm count) { return read_array(string, result, count, 4); }
+bool read_array_u64le(String* string, u64* result, umm count) { return read_array(string, result, count, 8); }
+
+bool view_array_u16le(String* string, const u16** result, umm count) { return view_array(string, (const void**) result, count, 2); }
+bool view_array_u32le(String* string, const u32** result, umm count) { return view_array(string, (const void**) result, count, 4); }
+bool view_array_u64le(String* string, const u64** result, umm count) { return view_array(string, (const void**) result, count, 8); }
+
+bool read_array_u16be(String* string, u16* result, umm count)
+{
+    if (count > string->length / 2)
+        return false;
+
+    copy_swapped_u16(result, string->data, count);
+    consume(string, count * 2);
+    return true;
+}
+
+bool read_array_u32be(String* string, u32* result, umm count)
+{
+    if (count > string->length / 4)
+        return false;
+
+    copy_swapped_u32(result, string->data, count);
+    consume(string, count * 4);
+    return true;
+}
+
+bool read_array_u64be(String* string, u64* result, umm count)
+{
+    if (count > string->length / 8)
+        return false;
+
+    copy_swapped_u64(result, string->data, count);
+    consume(string, count * 8);
+    return true;
+}
+
+
+bool read_varint(String* string, u64* result)
+{
+    u64 value = 0;
+    for (umm i = 0; i < string->length && i < 10; i++)
+    {
+        u8 byte = string->data[i];
+        value |= (u64)(byte & 0x7F) << (i * 7);
+        if (byte & 0x80)
+            continue;
+
+        // The tenth byte only has room for the top bit.
+        if (i == 9 && byte > 1)
+            return false;
+
+        *result = value;
+        consume(string, i + 1);
+        return true;
+    }
+    return false;
+}
+
+bool read_svarint(String* string, i64* result)
+{
+    u64 value;
+    if (!read_varint(string, &value))
+        return false;
+    *result = zigzag_decode64(value);
+    return true;
+}
+
+
+//
+// File path utilities.
+//
+
+
+String get_file_name(String path)
+{
+    umm last_slash_index = find_last_occurance_of_any(path, slash_chars);
+    if (last_slash_index == NOT_FOUND)
+        last_slash_index = 0;
+
+    umm start_index = last_slash_index + 1;
+    umm length = path.length - start_index;
+
+    String file_name = substring(path, start_index, length);
+    return file_name;
+}
+
+
+String get_file_name_without_extension(String path)
+{
+    umm last_slash_index = find_last_occurance_of_any(path, slash_chars);
+    if (last_slash_index != NOT_FOUND)
+        consume(&path, last_slash_index + 1);
+
+    umm last_dot_index = find_last_occurance(path, '.');
+    if (last_dot_index != NOT_FOUND)
+        path.length = last_dot_index;
+
+    return path;
+}
+
+
+String get_parent_directory_path(String path)
+{
+    umm last_slash_index = find_last_occurance_of_any(path, slash_chars);
+    // @Incomplete if (last_slash_index == NOT_FOUND)
+
+    String parent = substring(path, 0, last_slash_index);
+    return parent;
+}
+
+
+
+//
+// 16-bit strings. These mostly exist for interfacing with Windows.
+// That's why conversion routines return null terminated strings, and why
+// we don't really support any operations on them.
+//
+
+
+
+static inline bool is_legal_code_point(u32 code_point)
+{
+    if (code_point > 0x10FFFF) return false;
+    if (code_point >= 0xD800 && code_point <= 0xDFFF) return false;
+    return true;
+}
+
+
+static inline u32 get_utf8_sequence_length(u32 code_point)
+{
+    if (code_point <      0x80) return 1;
+    if (code_point <     0x800) return 2;
+    if (code_point <   0x10000) return 3;
+    if (code_point <  0x200000) return 4;
+    if (code_point < 0x4000000) return 5;
+                                return 6;
+}
+
+
+static void encode_utf8_sequence(u32 code_point, u8* target, u32 length)
+{
+    switch (length)
+    {
+    case 6:  target[5] = (u8)((code_point | 0x80) & 0xBF); code_point >>= 6;  // fall-through
+    case 5:  target[4] = (u8)((code_point | 0x80) & 0xBF); code_point >>= 6;  // fall-through
+    case 4:  target[3] = (u8)((code_point | 0x80) & 0xBF); code_point >>= 6;  // fall-through
+    case 3:  target[2] = (u8)((code_point | 0x80) & 0xBF); code_point >>= 6;  // fall-through
+    case 2:  target[1] = (u8)((code_point | 0x80) & 0xBF); code_point >>= 6;  // fall-through
+    }
+
+    static constexpr u8 FIRST_MASK[7] = { 0x00, 0x00, 0xC0, 0xE0, 0xF0, 0xF8, 0xFC };
+    target[0] = (u8)(code_point | FIRST_MASK[length]);
+}
+
+
+static bool decode_utf8_sequence(String* string, u32* out_code_point)
+{
+    umm length = string->length;
+    u8* data = string->data;
+    DebugAssert(length);
+
+    u8 unit1 = data[0];
+    consume(string, 1);
+
+    if (unit1 < 0x80)
+    {
+        *out_code_point = unit1;
+        return true;
+    }
+
+    if (unit1 >= 0x80 && unit1 <= 0xBF)
+        return false;
+
+
+    u32 consume_count = 0;
+    u32 code_point = unit1;
+
+    #define HandleUnit                                  \
+    {                                                   \
+        if (!--length)  return false;                   \
+        u8 unit = data[++consume_count];                \
+        if (unit < 0x80 || unit > 0xBF)  return false;  \
+        code_point = (code_point << 6) + unit;          \
+    }
+
+    if (unit1 >= 0xFC) HandleUnit  // 6 units
+    if (unit1 >= 0xF8) HandleUnit  // 5 units
+    if (unit1 >= 0xF0) HandleUnit  // 4 units
+    if (unit1 >= 0xE0) HandleUnit  // 3 units
+    HandleUnit                     // 2 units
+
+    #undef HandleUnit
+
+
+    static constexpr u32 DECODING_MAGIC[] =
+    {
+        0x00000000,
+        0x00000000, 0x00003080, 0x000E2080,
+        0x03C82080, 0xFA082080, 0x82082080
+    };
+
+    code_point -= DECODING_MAGIC[consume_count + 1];
+    consume(string, consume_count);
+
+    *out_code_point = code_point;
+    return true;
+}
+
+
+static void encode_utf16_sequence(u32 code_point, u16* target, u32 length)
+{
+    if (length == 2)
+    {
+        code_point -= 0x10000;
+        target[0] = 0xD800 + (u16)(code_point >> 10);
+        target[1] = 0xDC00 + (u16)(code_point & 0x3FF);
+        return;
+    }
+
+    target[0] = (u16) code_point;
+}
+
+
+// If this function finds an unpaired surrogate, it will decode it as a
+// code point equal to that surrogate. It is up to the caller to check if
+// the returned value is a legal Unicode code point, if relevant.
+static u32 decode_utf16_sequence(String16* string)
+{
+    DebugAssert(string->length);
+    u32 unit1 = string->data[0];
+    string->data++;
+    string->length--;
+
+    if (unit1 >= 0xD800 && unit1 <= 0xDBFF)
+    {
+        if (!string->length)
+            return unit1;  // Unpaired high surrogate.
+
+        u32 unit2 = string->data[0];
+        if (unit2 < 0xDC00 || unit2 > 0xDFFF)
+            return unit1;  // Unpaired high surrogate.
+
+        string->data++;
+        string->length--;
+        return (((unit1 - 0xD800) << 10) | (unit2 - 0xDC00)) + 0x10000;
+    }
+
+    // Might be an unpaired low surrogate, but it makes no difference.
+    return unit1;
+}
+
+
+static umm convert_utf8_to_utf16(String16* target, String source)
+{
+    umm utf16_length = 0;
+
+    while (source)
+    {
+        u32 code_point;
+        if (!decode_utf8_sequence(&source, &code_point))
+            continue;
+
+        u32 sequence_length = (code_point < 0x10000) ? 1 : 2;
+        if (target)
+        {
+            u16* sequence = target->data + utf16_length;
+            encode_utf16_sequence(code_point, sequence, sequence_length);
+        }
+
+        utf16_length += sequence_length;
+    }
+
+    return utf16_length;
+}
+
+
+static umm convert_utf16_to_utf8(String* target, String16 source)
+{
+    umm utf8_length = 0;
+
+    while (source)
+    {
+        u32 code_point = decode_utf16_sequence(&source);
+
+        u32 sequence_length = get_utf8_sequence_length(code_point);
+        if (target)
+        {
+            u8* sequence = target->data + utf8_length;
+            encode_utf8_sequence(code_point, sequence, sequence_length);
+        }
+
+        utf8_length += sequence_length;
+    }
+
+    return utf8_length;
+}
+
+
+// The returned string is null terminated.
+String16 make_string16(const u16* c_string)
+{
+    umm length = length_of_c_style_string(c_string);
+
+    String16 result;
+    result.length = length;
+    result.data = LK_RegionArray(temp, u16, length + 1);
+
+    copy(result.data, c_string, 2 * (length + 1));
+
+    return result;
+}
+
+// The returned string is null terminated.
+String16 convert_utf8_to_utf16(String string, Region* memory)
+{
+    umm length = convert_utf8_to_utf16(NULL, string);
+
+    String16 string16;
+    string16.length = length;
+    string16.data = LK_RegionArray(memory, u16, length + 1);
+    string16.data[length] = 0;
+
+    length = convert_utf8_to_utf16(&string16, string);
+    DebugAssert(string16.length == length);
+
+    return string16;
+}
+
+// The returned string is null terminated.
+String convert_utf16_to_utf8(String16 string, Region* memory)
+{
+    umm length = convert_utf16_to_utf8(NULL, string);
+
+    String string8;
+    string8.length = length;
+    string8.data = LK_RegionArray(memory, u8, length + 1);
+    string8.data[length] = 0;
+
+    length = convert_utf16_to_utf8(&string8, string);
+    DebugAssert(string8.length == length);
+
+    return string8;
+}
+
+
+
+//
+// String building utilities.
+//
+
+
+
+static inline bool is_inline(String_Builder* builder)
+{
+    return builder->string.data == builder->inline_buffer;
+}
+
+
+void free_string_builder(String_Builder* builder)
+{
+    Region* region = builder->region;
+    if (region)
+    {
+        // Give the space back if nothing was allocated after us.
+        if (builder->string.data)
+            lk_region_resize_in_place(region, builder->string.data, builder->capacity, 0);
+    }
+    else if (!is_inline(builder))
+    {
+        free(builder->string.data);
+    }
+
+    ZeroStruct(builder);
+    builder->region = region;
+}
+
+
+void clear(String_Builder* builder)
+{
+    builder->string.length = 0;
+    if (builder->string.data)
+        builder->string.data[0] = 0;
+}
+
+
+// Changes the capacity, which must be larger than the string (and its null terminator).
+static void set_capacity(String_Builder* builder, umm new_capacity)
+{
+    u8* old_data = builder->string.data;
+    u8* new_data;
+
+    if (builder->region)
+    {
+        if (old_data && lk_region_resize_in_place(builder->region, old_data, builder->capacity, new_capacity))
+        {
+            builder->capacity = new_capacity;
+            return;
+        }
+
+        new_data = LK_RegionArray(builder->region, u8, new_capacity);
+        if (old_data)
+            copy(new_data, old_data, builder->string.length + 1);
+    }
+    else if (new_capacity <= sizeof(builder->inline_buffer))
+    {
+        new_data = builder->inline_buffer;
+        new_capacity = sizeof(builder->inline_buffer);
+        if (old_data && !is_inline(builder))
+        {
+            copy(new_data, old_data, builder->string.length + 1);
+            free(old_data);
+        }
+    }
+    else if (!old_data || is_inline(builder))
+    {
+        new_data = (u8*) malloc(new_capacity);
+        if (old_data)
+            copy(new_data, old_data, builder->string.length + 1);
+    }
+    else
+    {
+        new_data = (u8*) realloc(old_data, new_capacity);
+    }
+
+    builder->string.data = new_data;
+    builder->capacity = new_capacity;
+}
+
+
+void maybe_resize(String_Builder* builder, umm insert_length)
+{
+    umm new_length = builder->string.length + insert_length;
+    if (new_length >= builder->capacity)
+    {
+        umm new_capacity = builder->capacity;
+        if (!new_capacity) new_capacity = 32;
+
+        // growth factor of 1.5
+        do new_capacity = new_capacity + (new_capacity >> 1);
+        while (new_length >= new_capacity);
+
+        set_capacity(builder, new_capacity);
+    }
+}
+
+
+void reserve(String_Builder* builder, umm length)
+{
+    if (length >= builder->capacity)
+        set_capacity(builder, length + 1);
+}
+
+
+void shrink_to_fit(String_Builder* builder)
+{
+    if (!builder->string.data || is_inline(builder))
+        return;
+
+    umm new_capacity = builder->string.length + 1;
+    if (builder->region)
+    {
+        // Region memory can only be given back from the top.
+        if (lk_region_resize_in_place(builder->region, builder->string.data, builder->capacity, new_capacity))
+            builder->capacity = new_capacity;
+        return;
+    }
+
+    set_capacity(builder, new_capacity);
+}
+
+
+String take_string(String_Builder* builder)
+{
+    String result = builder->string;
+    if (!result.data)
+        return result;
+
+    if (is_inline(builder))
+    {
+        result.data = (u8*) malloc(result.length + 1);
+        copy(result.data, builder->string.data, result.length + 1);
+    }
+    else if (builder->region)
+    {
+        shrink_to_fit(builder);
+    }
+    else
+    {
+        result.data = (u8*) realloc(result.data, result.length + 1);
+    }
+
+    Region* region = builder->region;
+    ZeroStruct(builder);
+    builder->region = region;
+
+    return result;
+}
+
+
+void append(String_Builder* builder, const void* data, umm length)
+{
+    maybe_resize(builder, length);
+    copy(builder->string.data + builder->string.length, data, length);
+    builder->string.length += length;
+    builder->string.data[builder->string.length] = 0;
+}
+
+
+void insert(String_Builder* builder, umm at_offset, const void* data, umm length)
+{
+    maybe_resize(builder, length);
+
+    umm string_length = builder->string.length;
+    DebugAssert(at_offset <= string_length);
+    builder->string.length += length;
+
+    u8* from = builder->string.data + at_offset;
+    u8* to = from + length;
+    umm move_size = string_length - at_offset + 1;
+
+    move(to, from, move_size);
+    copy(from, data, length);
+}
+
+
+void remove(String_Builder* builder, umm at_offset, umm length)
+{
+    umm string_length = builder->string.length;
+    DebugAssert(at_offset <= string_length);
+    DebugAssert(at_offset + length <= string_length);
+    builder->string.length -= length;
+
+    u8* to = builder->string.data + at_offset;
+    u8* from = to + length;
+    umm move_size = string_length - at_offset - length + 1;
+    move(to, from, move_size);
+}
+
+
+//
+// Number formatting utilities.
+//
+
+
+static constexpr char DIGIT_PAIRS[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static constexpr u64 POWERS_OF_TEN_U64[] =
+{
+    1ull,
+    10ull,
+    100ull,
+    1000ull,
+    10000ull,
+    100000ull,
+    1000000ull,
+    10000000ull,
+    100000000ull,
+    1000000000ull,
+    10000000000ull,
+    100000000000ull,
+    1000000000000ull,
+    10000000000000ull,
+    100000000000000ull,
+    1000000000000000ull,
+    10000000000000000ull,
+    100000000000000000ull,
+    1000000000000000000ull,
+    10000000000000000000ull,
+};
+
+static inline u32 count_decimal_digits(u64 value)
+{
+    if (value < 10)
+        return 1;
+
+    // Approximate log10 from log2, then correct by one comparison.
+    u32 guess = ((64 - count_leading_zeros64(value)) * 1233) >> 12;
+    return guess + (value >= POWERS_OF_TEN_U64[guess]);
+}
+
+// Writes exactly digit_count digits of value, ending just before 'end'.
+static inline void write_decimal_digits(u8* end, u64 value, u32 digit_count)
+{
+    u8* write = end;
+    while (digit_count >= 2)
+    {
+        u64 pair = (value % 100) * 2;
+        value /= 100;
+        write -= 2;
+        write[0] = DIGIT_PAIRS[pair];
+        write[1] = DIGIT_PAIRS[pair + 1];
+        digit_count -= 2;
+    }
+
+    if (digit_count)
+        *(--write) = (u8)('0' + value % 10);
+}
+
+// Makes room for at least 'length' more bytes and returns where they go.
+// The caller writes them and then calls finish_append with how many it actually wrote.
+static inline u8* begin_append(String_Builder* builder, umm length)
+{
+    maybe_resize(builder, length);
+    return builder->string.data + builder->string.length;
+}
+
+static inline void finish_append(String_Builder* builder, u8* end)
+{
+    builder->string.length = end - builder->string.data;
+    builder->string.data[builder->string.length] = 0;
+}
+
+
+void append_u64(String_Builder* builder, u64 value)
+{
+    u8* write = begin_append(builder, 20);
+    u32 digit_count = count_decimal_digits(value);
+    write_decimal_digits(write + digit_count, value, digit_count);
+    finish_append(builder, write + digit_count);
+}
+
+void append_i64(String_Builder* builder, i64 value)
+{
+    u8* write = begin_append(builder, 20);
+
+    u64 magnitude = (u64) value;
+    if (value < 0)
+    {
+        *(write++) = '-';
+        magnitude = 0 - magnitude;
+    }
+
+    u32 digit_count = count_decimal_digits(magnitude);
+    write_decimal_digits(write + digit_count, magnitude, digit_count);
+    finish_append(builder, write + digit_count);
+}
+
+void append_hex_u64(String_Builder* builder, u64 value)
+{
+    u8* write = begin_append(builder, 16);
+
+    u32 digit_count = value ? (67 - count_leading_zeros64(value)) / 4 : 1;
+    for (u32 i = digit_count; i--;)
+    {
+        write[i] = "0123456789abcdef"[value & 15];
+        value >>= 4;
+    }
+
+    finish_append(builder, write + digit_count);
+}
+
+
+//
+// Shortest round-trip float formatting is the Schubfach algorithm, from Giulietti's
+// "The Schubfach way to render doubles", following the reference Java implementation.
+// Both f32 and f64 go through the double precision path, with their own significand
+// and exponent ranges.
+//
+
+
+struct Schubfach_Format
+{
+    i32 precision;      // significand bits, including the implicit one
+    i32 min_exponent;   // q of subnormals
+    i32 exponent_bits;
+};
+
+static constexpr Schubfach_Format SCHUBFACH_F64 = { 53, -1074, 11 };
+static constexpr Schubfach_Format SCHUBFACH_F32 = { 24,  -149,  8 };
+
+
+static inline i32 floor_log10_pow2(i32 e)                { return (i32)(((i64) e * 661971961083ll) >> 41); }
+static inline i32 floor_log10_three_quarters_pow2(i32 e) { return (i32)(((i64) e * 661971961083ll - 274743187321ll) >> 41); }
+static inline i32 floor_log2_pow10(i32 e)                { return (i32)(((i64) e * 913124641741ll) >> 38); }
+
+// Round to odd of g * cp, scaled down by 2^127.
+static inline u64 schubfach_round_to_odd(u64 g1, u64 g0, u64 cp)
+{
+    const u64 MASK_63 = ((u64) 1 << 63) - 1;
+
+    u64 unused;
+    u64 x1 = multiply_u64(g0, cp, &unused);
+    u64 y0;
+    u64 y1 = multiply_u64(g1, cp, &y0);
+
+    u64 z = (y0 >> 1) + x1;
+    u64 vbp = y1 + (z >> 63);
+    return vbp | (((z & MASK_63) + MASK_63) >> 63);
+}
+
+// Finds the decimal f * 10^e closest to c * 2^q among the shortest that round-trip.
+static void schubfach_to_decimal(const Schubfach_Format* format, i32 q, u64 c, u64* out_f, i32* out_e)
+{
+    u64 c_min = (u64) 1 << (format->precision - 1);
+
+    u64 out = c & 1;
+    u64 cb  = c << 2;
+    u64 cbr = cb + 2;
+    u64 cbl;
+    i32 k;
+
+    // The interval is asymmetric at powers of two.
+    if (c != c_min || q == format->min_exponent)
+    {
+        cbl = cb - 2;
+        k = floor_log10_pow2(q);
+    }
+    else
+    {
+        cbl = cb - 1;
+        k = floor_log10_three_quarters_pow2(q);
+    }
+
+    i32 h = q + floor_log2_pow10(-k) + 2;
+
+    DebugAssert(k >= SCHUBFACH_G_MIN_K && k <= SCHUBFACH_G_MAX_K);
+    const u64* g = SCHUBFACH_G + 2 * (k - SCHUBFACH_G_MIN_K);
+
+    u64 vb  = schubfach_round_to_odd(g[0], g[1], cb  << h);
+    u64 vbl = schubfach_round_to_odd(g[0], g[1], cbl << h);
+    u64 vbr = schubfach_round_to_odd(g[0], g[1], cbr << h);
+
+    u64 s = vb >> 2;
+    // The reference only tries this for s >= 100, to always print at least two digits.
+    if (s >= 10)
+    {
+        // Try one digit less first: s' = floor(s / 10).
+        u64 unused;
+        u64 sp10 = 10 * multiply_u64(s, 115292150460684698ull << 4, &unused);
+        u64 tp10 = sp10 + 10;
+        bool upin = vbl + out <= (sp10 << 2);
+        bool wpin = (tp10 << 2) + out <= vbr;
+        if (upin != wpin)
+        {
+            *out_f = upin ? sp10 : tp10;
+            *out_e = k;
+            return;
+        }
+    }
+
+    u64 t = s + 1;
+    bool uin = vbl + out <= (s << 2);
+    bool win = (t << 2) + out <= vbr;
+    *out_e = k;
+    if (uin != win)
+    {
+        *out_f = uin ? s : t;
+        return;
+    }
+
+    // Both are in the interval, pick the closer one, or the even one on a tie.
+    i64 cmp = (i64)(vb - ((s + t) << 1));
+    *out_f = (cmp < 0 || (cmp == 0 && (s & 1) == 0)) ? s : t;
+}
+
+// Writes f * 10^e, using plain notation for decimal exponents in [-7, 21), and
+// exponent notation otherwise. Returns the end of the written text.
+static u8* write_shortest_decimal(u8* write, u64 f, i32 e)
+{
+    // Strip trailing zeros.
+    while (f >= 10 && f % 10 == 0)
+    {
+        f /= 10;
+        e++;
+    }
+
+    i32 digit_count = (i32) count_decimal_digits(f);
+    i32 point = digit_count + e;  // position of the decimal point relative to the first digit
+
+    if (point >= digit_count && point <= 21)
+    {
+        // Integer: digits followed by zeros.
+        write_decimal_digits(write + digit_count, f, digit_count);
+        write += digit_count;
+        for (i32 i = digit_count; i < point; i++)
+            *(write++) = '0';
+    }
+    else if (point > 0 && point <= 21)
+    {
+        // Decimal point somewhere within the digits.
+        write_decimal_digits(write + digit_count + 1, f, digit_count);
+        move(write, write + 1, point);
+        write[point] = '.';
+        write += digit_count + 1;
+    }
+    else if (point > -6 && point <= 0)
+    {
+        // 0.000ddd
+        *(write++) = '0';
+        *(write++) = '.';
+        for (i32 i = point; i < 0; i++)
+            *(write++) = '0';
+        write_decimal_digits(write + digit_count, f, digit_count);
+        write += digit_count;
+    }
+    else
+    {
+        // d.ddde-xx
+        write_decimal_digits(write + digit_count + 1, f, digit_count);
+        write[0] = write[1];
+        if (digit_count > 1)
+        {
+            write[1] = '.';
+            write += digit_count + 1;
+        }
+        else
+        {
+            write += 1;
+        }
+
+        i32 exponent = point - 1;
+        *(write++) = 'e';
+        if (exponent < 0)
+        {
+            *(write++) = '-';
+            exponent = -exponent;
+        }
+
+        u32 exponent_digits = count_decimal_digits(exponent);
+        write_decimal_digits(write + exponent_digits, exponent, exponent_digits);
+        write += exponent_digits;
+    }
+
+    return write;
+}
+
+struct Float_Parts
+{
+    bool negative;
+    u64  t;   // stored significand bits
+    u64  bq;  // biased exponent
+    u64  exponent_mask;
+};
+
+static inline Float_Parts split_float(const Schubfach_Format* format, u64 bits)
+{
+    i32 significand_bits = format->precision - 1;
+
+    Float_Parts parts;
+    parts.exponent_mask = ((u64) 1 << format->exponent_bits) - 1;
+    parts.t        = bits & (((u64) 1 << significand_bits) - 1);
+    parts.bq       = (bits >> significand_bits) & parts.exponent_mask;
+    parts.negative = (bits >> (significand_bits + format->exponent_bits)) & 1;
+    return parts;
+}
+
+// For finite non-zero floats.
+static void shortest_decimal(const Schubfach_Format* format, Float_Parts parts, u64* f, i32* e)
+{
+    i32 significand_bits = format->precision - 1;
+
+    if (parts.bq != 0)
+    {
+        // Normal. Here mq = -q.
+        i32 mq = -format->min_exponent + 1 - (i32) parts.bq;
+        u64 c = ((u64) 1 << significand_bits) | parts.t;
+
+        // Small integers are printed as they are.
+        if (mq > 0 && mq < format->precision && ((c >> mq) << mq) == c)
+        {
+            *f = c >> mq;
+            *e = 0;
+            return;
+        }
+
+        schubfach_to_decimal(format, -mq, c, f, e);
+    }
+    else
+    {
+        schubfach_to_decimal(format, format->min_exponent, parts.t, f, e);
+    }
+}
+
+// Writes inf, -inf or nan and returns the end, or returns NULL if the value is finite.
+static u8* write_non_finite(u8* write, Float_Parts parts)
+{
+    if (parts.bq != parts.exponent_mask)
+        return NULL;
+
+    if (parts.t)
+    {
+        copy(write, "nan", 3);
+        return write + 3;
+    }
+
+    if (parts.negative)
+        *(write++) = '-';
+    copy(write, "inf", 3);
+    return write + 3;
+}
+
+static void append_float_shortest(String_Builder* builder, const Schubfach_Format* format, u64 bits)
+{
+    u8* write = begin_append(builder, 32);
+    Float_Parts parts = split_float(format, bits);
+
+    if (u8* end = write_non_finite(write, parts))
+    {
+        finish_append(builder, end);
+        return;
+    }
+
+    if (parts.negative)
+        *(write++) = '-';
+
+    if (!parts.bq && !parts.t)
+    {
+        *(write++) = '0';
+        finish_append(builder, write);
+        return;
+    }
+
+    u64 f;
+    i32 e;
+    shortest_decimal(format, parts, &f, &e);
+
+    write = write_shortest_decimal(write, f, e);
+    finish_append(builder, write);
+}
+
+void append_f32(String_Builder* builder, f32 value)
+{
+    u32 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    append_float_shortest(builder, &SCHUBFACH_F32, bits);
+}
+
+void append_f64(String_Builder* builder, f64 value)
+{
+    u64 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    append_float_shortest(builder, &SCHUBFACH_F64, bits);
+}
+
+
+// Rounds fraction / 2^shift * 10^precision to the nearest integer, ties to even.
+// This is exact: fraction * 10^precision is below 2^110, so it fits in 128 bits.
+static u64 round_scaled_fraction(u64 fraction, u32 shift, u32 precision)
+{
+    if (shift >= 128)
+        return 0;
+
+    u64 low;
+    u64 high = multiply_u64(fraction, POWERS_OF_TEN_U64[precision], &low);
+
+    // Shift right by (shift - 1), keeping the rounding bit in bit 0 and the rest as sticky.
+    u32 s = shift - 1;
+    u64 sticky = 0;
+    if (s >= 64)
+    {
+        sticky = low | (high & (((u64) 1 << (s - 64)) - 1));
+        low  = high >> (s - 64);
+        high = 0;
+    }
+    else if (s)
+    {
+        sticky = low & (((u64) 1 << s) - 1);
+        low  = (low >> s) | (high << (64 - s));
+        high = high >> s;
+    }
+
+    bool round_bit = low & 1;
+    low = (low >> 1) | (high << 63);
+
+    if (round_bit && (sticky || (low & 1)))
+        low++;
+
+    return low;
+}
+
+static void append_float_fixed(String_Builder* builder, const Schubfach_Format* format, u64 bits, u32 precision)
+{
+    DebugAssert(precision <= 17);
+    if (precision > 17)
+        precision = 17;
+
+    // Large enough for the digits of the largest f64, the point and the fraction.
+    u8* write = begin_append(builder, 350);
+    Float_Parts parts = split_float(format, bits);
+
+    if (u8* end = write_non_finite(write, parts))
+    {
+        finish_append(builder, end);
+        return;
+    }
+
+    if (parts.negative)
+        *(write++) = '-';
+
+    i32 significand_bits = format->precision - 1;
+    u64 c = parts.bq ? (((u64) 1 << significand_bits) | parts.t) : parts.t;
+    i32 q = parts.bq ? (format->min_exponent - 1 + (i32) parts.bq) : format->min_exponent;
+
+    u64 integer_part = 0;
+    u64 fraction = 0;
+    bool large = false;
+    if (q < 0 && !precision)
+    {
+        // Ties round to an even integer part.
+        integer_part = round_scaled_fraction(c, -q, 0);
+    }
+    else if (q < 0)
+    {
+        u32 shift = -q;
+        u64 fraction_bits = c;
+        if (shift < 64)
+        {
+            integer_part  = c >> shift;
+            fraction_bits = c & (((u64) 1 << shift) - 1);
+        }
+
+        fraction = round_scaled_fraction(fraction_bits, shift, precision);
+        if (fraction == POWERS_OF_TEN_U64[precision])
+        {
+            fraction = 0;
+            integer_part++;
+        }
+    }
+    else if (q < 64 && ((c << q) >> q) == c)
+    {
+        integer_part = c << q;
+    }
+    else
+    {
+        // Too large for u64. Write the shortest digits that round-trip, padded with zeros,
+        // instead of the exact binary value.
+        large = true;
+
+        u64 f;
+        i32 e;
+        shortest_decimal(format, parts, &f, &e);
+
+        u32 digit_count = count_decimal_digits(f);
+        write_decimal_digits(write + digit_count, f, digit_count);
+        write += digit_count;
+        for (i32 i = 0; i < e; i++)
+            *(write++) = '0';
+    }
+
+    if (!large)
+    {
+        u32 digit_count = count_decimal_digits(integer_part);
+        write_decimal_digits(write + digit_count, integer_part, digit_count);
+        write += digit_count;
+    }
+
+    if (precision)
+    {
+        *(write++) = '.';
+        write_decimal_digits(write + precision, fraction, precision);
+        write += precision;
+    }
+
+    finish_append(builder, write);
+}
+
+void append_f32(String_Builder* builder, f32 value, u32 precision)
+{
+    u32 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    append_float_fixed(builder, &SCHUBFACH_F32, bits, precision);
+}
+
+void append_f64(String_Builder* builder, f64 value, u32 precision)
+{
+    u64 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    append_float_fixed(builder, &SCHUBFACH_F64, bits, precision);
+}
+
+
+//
+// Formatting utilities.
+//
+
+
+static void append_utf16_as_utf8(String_Builder* builder, String16 string)
+{
+    umm length = convert_utf16_to_utf8(NULL, string);
+
+    String target;
+    target.data = begin_append(builder, length);
+    target.length = length;
+
+    convert_utf16_to_utf8(&target, string);
+    finish_append(builder, target.data + length);
+}
+
+static void append_format_argument(String_Builder* builder, Format_Argument* argument, String spec)
+{
+    bool hex = false;
+    bool has_precision = false;
+    u64 precision = 0;
+
+    if (spec && spec.data[0] == 'x')
+    {
+        hex = true;
+    }
+    else if (spec && spec.data[0] == '.')
+    {
+        consume(&spec, 1);
+        has_precision = parse_u64(spec, &precision);
+        DebugAssert(has_precision);
+    }
+
+    switch (argument->kind)
+    {
+    case Format_Argument::STRING:    append(builder, argument->string);                                break;
+    case Format_Argument::STRING16:  append_utf16_as_utf8(builder, argument->string16);                break;
+    case Format_Argument::BOOL:      append(builder, argument->unsigned_value ? "true"_s : "false"_s); break;
+
+    case Format_Argument::CHARACTER:
+    {
+        u8 character = (u8) argument->unsigned_value;
+        append(builder, &character, 1);
+    } break;
+
+    case Format_Argument::UNSIGNED:
+    {
+        if (hex) append_hex_u64(builder, argument->unsigned_value);
+        else     append_u64    (builder, argument->unsigned_value);
+    } break;
+
+    case Format_Argument::SIGNED:
+    {
+        if (hex) append_hex_u64(builder, (u64) argument->signed_value);
+        else     append_i64    (builder, argument->signed_value);
+    } break;
+
+    case Format_Argument::F32:
+    {
+        if (has_precision) append_f32(builder, (f32) argument->float_value, (u32) precision);
+        else               append_f32(builder, (f32) argument->float_value);
+    } break;
+
+    case Format_Argument::F64:
+    {
+        if (has_precision) append_f64(builder, argument->float_value, (u32) precision);
+        else               append_f64(builder, argument->float_value);
+    } break;
+
+    case Format_Argument::POINTER:
+    {
+        append(builder, "0x"_s);
+        append_hex_u64(builder, argument->unsigned_value);
+    } break;
+    }
+}
+
+void format_arguments(String_Builder* builder, String format_string, Format_Argument* arguments, umm argument_count)
+{
+    String rest = format_string;
+    umm argument_index = 0;
+
+    while (rest)
+    {
+        // Copy everything up to the next brace in one go.
+        umm literal_length = find_first_occurance_of_any(rest, "{}"_s);
+        if (literal_length == NOT_FOUND)
+            literal_length = rest.length;
+
+        append(builder, rest.data, literal_length);
+        consume(&rest, literal_length);
+        if (!rest)
+            break;
+
+        u8 brace = rest.data[0];
+        if (rest.length > 1 && rest.data[1] == brace)
+        {
+            // {{ or }}
+            append(builder, &brace, 1);
+            consume(&rest, 2);
+            continue;
+        }
+
+        if (brace == '}')
+        {
+            DebugAssert(!"Unmatched } in format string.");
+            append(builder, &brace, 1);
+            consume(&rest, 1);
+            continue;
+        }
+
+        umm placeholder_length = find_first_occurance(rest, '}');
+        if (placeholder_length == NOT_FOUND)
+        {
+            DebugAssert(!"Unterminated { in format string.");
+            append(builder, rest);
+            break;
+        }
+
+        String spec = substring(rest, 1, placeholder_length - 1);
+        if (spec && spec.data[0] == ':')
+            consume(&spec, 1);
+        consume(&rest, placeholder_length + 1);
+
+        DebugAssert(argument_index < argument_count);
+        if (argument_index < argument_count)
+            append_format_argument(builder, &arguments[argument_index++], spec);
+    }
+
+    DebugAssert(argument_index == argument_count);
+}
+
+
+// tprint builds the string right at the top of temporary memory, where it can grow in place.
+String tprint_arguments(String format_string, Format_Argument* arguments, umm argument_count)
+{
+    String_Builder builder = {};
+    builder.region = temp;
+
+    format_arguments(&builder, format_string, arguments, argument_count);
+    return take_string(&builder);
+}
+
+
+//
+// Binary writing utilities.
+//
+
+
+Binary_Writer make_binary_writer(void* buffer, umm capacity)
+{
+    Binary_Writer writer;
+    writer.start = (u8*) buffer;
+    writer.cursor = writer.start;
+    writer.end = writer.start + capacity;
+    return writer;
+}
+
+Binary_Writer make_binary_writer(Region* memory, umm capacity)
+{
+    return make_binary_writer(LK_RegionArray(memory, u8, capacity), capacity);
+}
+
+
+Binary_Writer begin_binary_write(String_Builder* builder, umm max_length)
+{
+    u8* write = begin_append(builder, max_length);
+    return make_binary_writer(write, max_length);
+}
+
+void end_binary_write(String_Builder* builder, Binary_Writer* writer)
+{
+    DebugAssert(writer->start == builder->string.data + builder->string.length);
+    DebugAssert(writer->cursor <= writer->end);
+    finish_append(builder, writer->cursor);
+}
+
+
+void write_bytes(String_Builder* builder, const void* data, umm count)
+{
+    append(builder, data, count);
+}
+
+#define WriteToBuilder(name, type, size)                              \
+    void name(String_Builder* builder, type value)                    \
+    {                                                                 \
+        u8* write = begin_append(builder, size);                      \
+        Binary_Writer writer = make_binary_writer(write, size);       \
+        name(&writer, value);                                         \
+        finish_append(builder, writer.cursor);                        \
+    }
+
+WriteToBuilder(write_u8,      u8,  1)
+WriteToBuilder(write_u16le,   u16, 2)
+WriteToBuilder(write_u32le,   u32, 4)
+WriteToBuilder(write_u64le,   u64, 8)
+WriteToBuilder(write_u16be,   u16, 2)
+WriteToBuilder(write_u32be,   u32, 4)
+WriteToBuilder(write_u64be,   u64, 8)
+WriteToBuilder(write_varint,  u64, 10)
+WriteToBuilder(write_svarint, i64, 10)
+
+#undef WriteToBuilder
@@ -1,500 +1,1303 @@
-#pragma once
-
-/*
- *
- * -- header with most commonly used utilites
- *
- */
-
-
-//
-//
-// -- type definitions
-//
-//
-
-#include <inttypes.h>
-
-typedef uint8_t     u8;
-typedef uint16_t    u16;
-typedef uint32_t    u32;
-typedef uint64_t    u64;
-typedef uintptr_t   umm;
-
-typedef int8_t      i8;
-typedef int16_t     i16;
-typedef int32_t     i32;
-typedef int64_t     i64;
-typedef intptr_t    imm;
-
-typedef float  f32;
-typedef double f64;
-
-constexpr u32 U32_MAX = ~(u32)0;
-
-
-
-
-//
-//
-// -- macros
-//
-//
-
-//
-// Defer
-//
-
-template <typename F>
-struct Defer_RAII
-{
-    F f;
-    Defer_RAII(F f): f(f) {}
-    ~Defer_RAII() { f(); }
-};
-
-template <typename F>
-Defer_RAII<F> defer_function(F f)
-{
-    return Defer_RAII<F>(f);
-}
-
-
-#define Concatenate__(x, y) x##y
-#define Concatenate_(x, y)  Concatenate__(x, y)
-#define Concatenate(x, y)   Concatenate_(x, y)
-
-
-#define Defer(code)   auto Concatenate(_defer_, __COUNTER__) = defer_function([&] () { code; })
-
-
-//
-// Memory manipulation
-//
-
-#include <memory.h>
-
-#define ZeroStruct(address)    memset((address), 0, sizeof(*(address)));
-#define ZeroStaticArray(array) memset((array),   0, sizeof((array)));
-
-#define ArrayCount(array) (sizeof(array) / sizeof((array)[0]))
-#define ElementSize(array) sizeof((array)[0])
-
-#define MemberSize(Type, member) sizeof(((Type*) 0)->member)
-
-
-
-
-//
-//
-// -- Region: stack based memory utility
-//
-//
-
-
-#include "libraries/lk_region.h"
-
-typedef LK_Region Region;
-typedef LK_Region_Cursor Region_Cursor;
-
-#define RegionInit LK_RegionInit
-
-#define RegionValue(region_ptr, type) LK_RegionValue(region_ptr, type) 
-#define RegionArray(region_ptr, type, count) LK_RegionArray(region_ptr, type, count) 
-#define RegionValueAligned(region_ptr, type, alignment) LK_RegionValueAligned(region_ptr, type, alignment) 
-#define RegionArrayAligned(region_ptr, type, count, alignment) LK_RegionArrayAligned(region_ptr, type, count, alignment)
-
-
-// Scoped memory
-// create stack instance to set a cursor position
-// at the end of the scope the cursor is rewinded
-
-struct Scoped_Region_Cursor
-{
-    Region* region;
-    Region_Cursor cursor;
-
-    inline Scoped_Region_Cursor(Region* region)
-    : region(region)
-    {
-        lk_region_cursor(region, &cursor);
-    }
-
-    inline ~Scoped_Region_Cursor()
-    {
-        lk_region_rewind(region, &cursor);
-    }
-};
-
-
-
-
-//
-//
-// -- temporary memory. rewind each frame!
-//
-//
-
-extern    Region temporary_memory;
-constexpr Region* temp = &temporary_memory;
-
-
-
-
-//
-//
-// -- lists
-//
-//
-
-
-//
-// doubly - linked intrusive list
-//
-
-template <typename T>
-struct List_Link
-{
-    T* prev;
-    T* next;
-};
-
-#define List(T, member) List_<T, &T::member>
-
-template <typename T, List_Link<T> T::* M>
-struct List_
-{
-    T* head;
-    T* tail;
-};
-
-template <typename T, List_Link<T> T::* M>
-inline void link(List_<T, M>* list, T* object)
-{
-    T* tail = list->tail;
-    if (tail)
-        (tail->*M).next = object;
-    else
-        list->head = object;
-
-    (object->*M).prev = tail;
-    (object->*M).next = NULL;
-    list->tail = object;
-}
-
-template <typename T, List_Link<T> T::* M>
-inline void unlink(List_<T, M>* list, T* object)
-{
-    T* prev = (object->*M).prev;
-    T* next = (object->*M).next;
-
-    if (prev)
-        (prev->*M).next = next;
-    else
-        list->head = next;
-
-    if (next)
-        (next->*M).prev = prev;
-    else
-        list->tail = prev;
-}
-
-// This junk is here just so we can use the ranged for syntax on Lists.
-// Ughh...
-
-template <typename T, List_Link<T> T::* M>
-struct ListIterator
-{
-    T* current;
-    inline bool operator!=(ListIterator<T, M> other) { return current != other.current; }
-    inline void operator++() { current = (current->*M).next; }
-    inline void operator--() { current = (current->*M).prev; }
-    inline T*   operator* () { return current; }
-};
-
-template <typename T, List_Link<T> T::* M>
-inline ListIterator<T, M> begin(List_<T, M>& list) { return { list.head }; }
-
-template <typename T, List_Link<T> T::* M>
-inline ListIterator<T, M> end(List_<T, M>& list) { return { NULL }; }
-
-
-//
-// intrusive retirement list
-//
-
-#define RetirementLink(Type) Type* next_retired;
-
-template <typename T>
-struct Retirement_List
-{
-    T* head;
-};
-
-template <typename T>
-void retire(Retirement_List<T>* list, T* value)
-{
-    value->next_retired = list->head;
-    list->head = value;
-}
-
-template <typename T>
-T* allocate(Region* region, Retirement_List<T>* list)
-{
-    T* value = list->head;
-    if (value)
-    {
-        list->head = value->next_retired;
-        ZeroStruct(value);
-    }
-    else
-    {
-        value = RegionValue(region, T);
-    }
-
-    return value;
-}
-
-
-
-
-//
-//
-// -- string utility
-//
-//
-
-
-#include <assert.h>
-#include <crtdbg.h>
-
-
-#define DebugAssert(test) _ASSERT(test) //assert(test)
-
-
-
-//
-// Memory, character and C-style string utilities.
-//
-
-
-void copy(void* to, const void* from, umm length);
-void move(void* to, void* from, umm length);
-bool compare(const void* m1, const void* m2, umm length);
-
-u16 endian_swap16(u16 value);
-u32 endian_swap32(u32 value);
-u64 endian_swap64(u64 value);
-
-bool is_decimal_digit(u8 character);
-bool is_whitespace(u8 character);
-
-umm length_of_c_style_string(const char* c_string);
-umm length_of_c_style_string(const u16* c_string);
-
-
-//
-// 8-bit strings.
-// When treated as text, UTF-8 encoding is assumed.
-//
-
-
-struct String
-{
-    umm length;
-    u8* data;
-
-    inline u8& operator[](umm index)
-    {
-        DebugAssert(index < length);
-        return data[index];
-    }
-
-    inline operator bool()
-    {
-        return length != 0;
-    }
-};
-
-#define StringArgs(string)  (int)((string).length), (const char*)((string).data)
-
-
-inline String operator ""_s(const char* c_string, umm length)
-{
-    String result;
-    result.length = length;
-    result.data = (u8*) c_string;
-    return result;
-}
-
-
-String make_string(const char* c_string);  // Allocates.
-char* make_c_style_string(String string);  // Allocates.
-String wrap_string(const char* c_string);
-
-String allocate_string(Region* memory, String string);
-String clone_string(String string);  // Allocates.
-
-String concatenate(String first, String second, String third = {}, String fourth = {}, String fifth = {}, String sixth = {});  // Allocates.
-String substring(String string, umm start_index, umm length);
-String concatenate_adjacent_substrings(String left, String right, String parent);
-
-bool operator==(String lhs, String rhs);
-bool operator==(String lhs, const char* rhs);
-bool operator==(const char* lhs, String rhs);
-
-inline bool operator!=(String      lhs, String      rhs) { return !(lhs == rhs); }
-inline bool operator!=(String      lhs, const char* rhs) { return !(lhs == rhs); }
-inline bool operator!=(const char* lhs, String      rhs) { return !(lhs == rhs); }
-
-bool prefix_equals(String string, String prefix);
-bool suffix_equals(String string, String suffix);
-
-constexpr umm NOT_FOUND = ~(umm) 0;
-
-umm find_first_occurance(String string, u8 of);
-umm find_first_occurance(String string, String of);
-umm find_first_occurance_of_any(String string, String any_of);
-
-umm find_last_occurance(String string, u8 of);
-umm find_last_occurance(String string, String of);
-umm find_last_occurance_of_any(String string, String any_of);
-
-void replace_all_occurances(String string, u8 what, u8 with_what);
-
-u32 compute_crc32(String data);
-
-
-//
-// Text reading utilities.
-//
-
-
-void consume(String* string, umm amount);
-void consume_whitespace(String* string);
-
-String consume_line(String* string);
-String consume_line_preserve_whitespace(String* string);
-String peek_line_preserve_whitespace(String string); // Doesn't modify string.
-String consume_until(String* string, u8 until_what);
-String consume_until(String* string, String until_what);
-String consume_until_any(String* string, String until_any_of);
-String consume_until_whitespace(String* string);
-
-String trim(String string);
-
-
-//
-// Binary reading utilities.
-//
-
-
-bool read_bytes(String* string, void* result, umm count);
-
-bool read_u8 (String* string, u8*  result);
-bool read_u16(String* string, u16* result);
-bool read_u32(String* string, u32* result);
-bool read_u64(String* string, u64* result);
-
-bool read_i8 (String* string, i8*  result);
-bool read_s16(String* string, i16* result);
-bool read_s32(String* string, i32* result);
-bool read_s64(String* string, i64* result);
-
-bool read_u16le(String* string, u16* result);
-bool read_u32le(String* string, u32* result);
-bool read_u64le(String* string, u64* result);
-
-bool read_u16be(String* string, u16* result);
-bool read_u32be(String* string, u32* result);
-bool read_u64be(String* string, u64* result);
-
-bool read_s16le(String* string, i16* result);
-bool read_s32le(String* string, i32* result);
-bool read_s64le(String* string, i64* result);
-
-bool read_s16be(String* string, i16* result);
-bool read_s32be(String* string, i32* result);
-bool read_s64be(String* string, i64* result);
-
-
-//
-// File path utilities.
-// Convention: directory paths *don't* end with a trailing slash.
-//
-
-
-String get_file_name(String path);
-String get_file_name_without_extension(String path);
-
-String get_parent_directory_path(String path);
-
-
-//
-// 16-bit strings. These mostly exist for interfacing with Windows.
-// That's why conversion routines return null terminated strings, and why
-// we don't really support any operations on them.
-//
-
-
-struct String16
-{
-    umm length;
-    u16* data;
-
-    inline u16& operator[](umm index)
-    {
-        DebugAssert(index < length);
-        return data[index];
-    }
-
-    inline operator bool()
-    {
-        return length != 0;
-    }
-};
-
-String16 make_string16(const u16* c_string);    // Allocates. The returned string is null terminated.
-String16 convert_utf8_to_utf16(String string);  // Allocates. The returned string is null terminated.
-String convert_utf16_to_utf8(String16 string);  // Allocates. The returned string is null terminated.
-
-
-//
-// String building utilities.
-//
-
-
-struct String_Builder
-{
-    String string;  // Heap allocated and null terminated.
-    umm capacity;
-};
-
-
-void free_string_builder(String_Builder* builder);
-void clear(String_Builder* builder);
-void append(String_Builder* builder, const void* data, umm length);
-void insert(String_Builder* builder, umm at_offset, const void* data, umm length);
-void remove(String_Builder* builder, umm at_offset, umm length);
-
-
-inline void append(String_Builder* builder, String string)
-{
-    append(builder, string.data, string.length);
-}
-
-inline void append(String_Builder* builder, const char* c_string)
-{
-    append(builder, c_string, length_of_c_style_string(c_string));
-}
-
-
-inline void insert(String_Builder* builder, umm at_offset, String string)
-{
-    insert(builder, at_offset, string.data, string.length);
-}
-
-inline void insert(String_Builder* builder, umm at_offset, const char* c_string)
-{
-    insert(builder, at_offset, c_string, length_of_c_style_string(c_string));
-}
\ No newline at end of file
+#pragma once
+
+/*
+ *
+ * -- header with most commonly used utilites
+ *
+ */
+
+
+//
+//
+// -- type definitions
+//
+//
+
+#include <inttypes.h>
+
+typedef uint8_t     u8;
+typedef uint16_t    u16;
+typedef uint32_t    u32;
+typedef uint64_t    u64;
+typedef uintptr_t   umm;
+
+typedef int8_t      i8;
+typedef int16_t     i16;
+typedef int32_t     i32;
+typedef int64_t     i64;
+typedef intptr_t    imm;
+
+typedef float  f32;
+typedef double f64;
+
+constexpr u32 U32_MAX = ~(u32)0;
+
+
+
+
+//
+//
+// -- macros
+//
+//
+
+//
+// Defer
+//
+
+template <typename F>
+struct Defer_RAII
+{
+    F f;
+    Defer_RAII(F f): f(f) {}
+    ~Defer_RAII() { f(); }
+};
+
+template <typename F>
+Defer_RAII<F> defer_function(F f)
+{
+    return Defer_RAII<F>(f);
+}
+
+
+#define Concatenate__(x, y) x##y
+#define Concatenate_(x, y)  Concatenate__(x, y)
+#define Concatenate(x, y)   Concatenate_(x, y)
+
+
+#define Defer(code)   auto Concatenate(_defer_, __COUNTER__) = defer_function([&] () { code; })
+
+
+//
+// Assertions
+//
+
+#include <assert.h>
+#include <crtdbg.h>
+
+
+#define DebugAssert(test) _ASSERT(test) //assert(test)
+
+
+//
+// Memory manipulation
+//
+
+#include <memory.h>
+
+#define ZeroStruct(address)    memset((address), 0, sizeof(*(address)));
+#define ZeroStaticArray(array) memset((array),   0, sizeof((array)));
+
+#define ArrayCount(array) (sizeof(array) / sizeof((array)[0]))
+#define ElementSize(array) sizeof((array)[0])
+
+#define MemberSize(Type, member) sizeof(((Type*) 0)->member)
+
+
+
+
+//
+//
+// -- Region: stack based memory utility
+//
+//
+
+
+#include "libraries/lk_region.h"
+
+typedef LK_Region Region;
+typedef LK_Region_Cursor Region_Cursor;
+
+#define RegionInit LK_RegionInit
+
+#define RegionValue(region_ptr, type) LK_RegionValue(region_ptr, type) 
+#define RegionArray(region_ptr, type, count) LK_RegionArray(region_ptr, type, count) 
+#define RegionValueAligned(region_ptr, type, alignment) LK_RegionValueAligned(region_ptr, type, alignment) 
+#define RegionArrayAligned(region_ptr, type, count, alignment) LK_RegionArrayAligned(region_ptr, type, count, alignment)
+
+
+// Scoped memory
+// create stack instance to set a cursor position
+// at the end of the scope the cursor is rewinded
+
+struct Scoped_Region_Cursor
+{
+    Region* region;
+    Region_Cursor cursor;
+
+    inline Scoped_Region_Cursor(Region* region)
+    : region(region)
+    {
+        lk_region_cursor(region, &cursor);
+    }
+
+    inline ~Scoped_Region_Cursor()
+    {
+        lk_region_rewind(region, &cursor);
+    }
+};
+
+
+
+
+//
+//
+// -- temporary memory. rewind each frame!
+//
+//
+
+extern    Region temporary_memory;
+constexpr Region* temp = &temporary_memory;
+
+
+
+
+//
+//
+// -- lists
+//
+//
+
+
+//
+// doubly - linked intrusive list
+//
+
+template <typename T>
+struct List_Link
+{
+    T* prev;
+    T* next;
+};
+
+#define List(T, member) List_<T, &T::member>
+
+template <typename T, List_Link<T> T::* M>
+struct List_
+{
+    T* head;
+    T* tail;
+};
+
+template <typename T, List_Link<T> T::* M>
+inline void link(List_<T, M>* list, T* object)
+{
+    T* tail = list->tail;
+    if (tail)
+        (tail->*M).next = object;
+    else
+        list->head = object;
+
+    (object->*M).prev = tail;
+    (object->*M).next = NULL;
+    list->tail = object;
+}
+
+template <typename T, List_Link<T> T::* M>
+inline void unlink(List_<T, M>* list, T* object)
+{
+    T* prev = (object->*M).prev;
+    T* next = (object->*M).next;
+
+    if (prev)
+        (prev->*M).next = next;
+    else
+        list->head = next;
+
+    if (next)
+        (next->*M).prev = prev;
+    else
+        list->tail = prev;
+}
+
+// Links 'object' right after 'at', or at the head if 'at' is NULL.
+template <typename T, List_Link<T> T::* M>
+inline void link_after(List_<T, M>* list, T* at, T* object)
+{
+    T* next = at ? (at->*M).next : list->head;
+
+    (object->*M).prev = at;
+    (object->*M).next = next;
+
+    if (at)
+        (at->*M).next = object;
+    else
+        list->head = object;
+
+    if (next)
+        (next->*M).prev = object;
+    else
+        list->tail = object;
+}
+
+// Links 'object' right before 'at', or at the tail if 'at' is NULL.
+template <typename T, List_Link<T> T::* M>
+inline void link_before(List_<T, M>* list, T* at, T* object)
+{
+    link_after(list, at ? (at->*M).prev : list->tail, object);
+}
+
+// Links 'count' objects at the tail, in array order.
+template <typename T, List_Link<T> T::* M>
+void link(List_<T, M>* list, T** objects, umm count)
+{
+    if (!count) return;
+
+    T* prev = list->tail;
+    for (umm i = 0; i < count; i++)
+    {
+        (objects[i]->*M).prev = prev;
+        if (prev)
+            (prev->*M).next = objects[i];
+        else
+            list->head = objects[i];
+        prev = objects[i];
+    }
+
+    (prev->*M).next = NULL;
+    list->tail = prev;
+}
+
+// Moves all of 'other' to the tail of 'list' in O(1). 'other' is left empty.
+template <typename T, List_Link<T> T::* M>
+inline void splice(List_<T, M>* list, List_<T, M>* other)
+{
+    if (!other->head) return;
+
+    if (list->tail)
+    {
+        (list->tail->*M).next = other->head;
+        (other->head->*M).prev = list->tail;
+    }
+    else
+    {
+        list->head = other->head;
+    }
+
+    list->tail = other->tail;
+    other->head = NULL;
+    other->tail = NULL;
+}
+
+
+// Stable in-place merge sort, O(n log n) without allocating. 'less' is called as less(T* a, T* b).
+// Runs of 2^i objects are merged like a binary counter, only following next links, and the
+// prev links are fixed in one pass at the end.
+
+template <typename T, List_Link<T> T::* M, typename Less>
+inline T* merge_sorted_runs(T* a, T* b, Less& less)
+{
+    // 'a' has the earlier objects, so it wins ties.
+    T* head;
+    T** tail = &head;
+    while (a && b)
+    {
+        if (less(b, a))
+        {
+            *tail = b;
+            tail = &(b->*M).next;
+            b = *tail;
+        }
+        else
+        {
+            *tail = a;
+            tail = &(a->*M).next;
+            a = *tail;
+        }
+    }
+
+    *tail = a ? a : b;
+    return head;
+}
+
+template <typename T, List_Link<T> T::* M, typename Less>
+void sort(List_<T, M>* list, Less&& less)
+{
+    T* runs[64] = {};  // runs[i] is NULL or a sorted run of 2^i objects.
+    umm run_count = 0;
+
+    T* object = list->head;
+    while (object)
+    {
+        T* next = (object->*M).next;
+        (object->*M).next = NULL;
+
+        umm i = 0;
+        for (; runs[i]; i++)
+        {
+            object = merge_sorted_runs<T, M>(runs[i], object, less);
+            runs[i] = NULL;
+        }
+        runs[i] = object;
+        if (run_count < i + 1)
+            run_count = i + 1;
+
+        object = next;
+    }
+
+    // Larger runs hold earlier objects.
+    T* head = NULL;
+    for (umm i = 0; i < run_count; i++)
+        if (runs[i])
+            head = merge_sorted_runs<T, M>(runs[i], head, less);
+
+    T* prev = NULL;
+    for (T* at = head; at; at = (at->*M).next)
+    {
+        (at->*M).prev = prev;
+        prev = at;
+    }
+
+    list->head = head;
+    list->tail = prev;
+}
+
+// This junk is here just so we can use the ranged for syntax on Lists.
+// Ughh...
+
+template <typename T, List_Link<T> T::* M>
+struct ListIterator
+{
+    T* current;
+    inline bool operator!=(ListIterator<T, M> other) { return current != other.current; }
+    inline void operator++() { current = (current->*M).next; }
+    inline void operator--() { current = (current->*M).prev; }
+    inline T*   operator* () { return current; }
+};
+
+template <typename T, List_Link<T> T::* M>
+inline ListIterator<T, M> begin(List_<T, M>& list) { return { list.head }; }
+
+template <typename T, List_Link<T> T::* M>
+inline ListIterator<T, M> end(List_<T, M>& list) { return { NULL }; }
+
+
+//
+// intrusive retirement list
+//
+
+#define RetirementLink(Type) Type* next_retired;
+
+template <typename T>
+struct Retirement_List
+{
+    T* head;
+};
+
+template <typename T>
+void retire(Retirement_List<T>* list, T* value)
+{
+    value->next_retired = list->head;
+    list->head = value;
+}
+
+template <typename T>
+T* allocate(Region* region, Retirement_List<T>* list)
+{
+    T* value = list->head;
+    if (value)
+    {
+        list->head = value->next_retired;
+        ZeroStruct(value);
+    }
+    else
+    {
+        value = RegionValue(region, T);
+    }
+
+    return value;
+}
+
+
+//
+// unrolled list
+// Elements are stored by value, N to a chunk, so iterating reads them mostly in order instead of
+// chasing a pointer per element. Appending never moves elements. Removing moves the last element
+// of the same chunk into the hole, so only pointers to that one change.
+// Elements never move between chunks, so a chunk is only let go of when it's empty. After many
+// removes, chunks before the tail can be left nearly empty, and iterating gets slower until clear.
+// Chunks come from 'memory', and emptied chunks are kept for reuse:
+//
+//     Chunked_List<Box> boxes = { &memory };
+//     Box* box = append(&boxes);
+//     for (Box* box : boxes)
+//         ...
+//
+
+template <typename T, umm N>
+struct List_Chunk
+{
+    List_Chunk* prev;
+    List_Chunk* next;
+    umm count;
+    T items[N];
+};
+
+template <typename T, umm N = 32>
+struct Chunked_List
+{
+    Region* memory;
+    List_Chunk<T, N>* head;
+    List_Chunk<T, N>* tail;  // Only the tail chunk is appended to, the others may have holes.
+    List_Chunk<T, N>* free_chunks;
+    umm count;
+};
+
+// Returns a zeroed element at the end of the list.
+template <typename T, umm N>
+T* append(Chunked_List<T, N>* list)
+{
+    typedef List_Chunk<T, N> Chunk;
+    Chunk* chunk = list->tail;
+    if (!chunk || chunk->count == N)
+    {
+        chunk = list->free_chunks;
+        if (chunk)
+            list->free_chunks = chunk->next;
+        else
+            chunk = RegionValue(list->memory, Chunk);
+
+        chunk->prev  = list->tail;
+        chunk->next  = NULL;
+        chunk->count = 0;
+
+        if (list->tail)
+            list->tail->next = chunk;
+        else
+            list->head = chunk;
+        list->tail = chunk;
+    }
+
+    T* element = &chunk->items[chunk->count++];
+    ZeroStruct(element);
+    list->count++;
+    return element;
+}
+
+template <typename T, umm N>
+inline T* append(Chunked_List<T, N>* list, const T& value)
+{
+    T* element = append(list);
+    *element = value;
+    return element;
+}
+
+template <typename T, umm N>
+void remove(Chunked_List<T, N>* list, List_Chunk<T, N>* chunk, umm index)
+{
+    chunk->items[index] = chunk->items[--chunk->count];
+    list->count--;
+    if (chunk->count) return;
+
+    if (chunk->prev)
+        chunk->prev->next = chunk->next;
+    else
+        list->head = chunk->next;
+
+    if (chunk->next)
+        chunk->next->prev = chunk->prev;
+    else
+        list->tail = chunk->prev;
+
+    chunk->next = list->free_chunks;
+    list->free_chunks = chunk;
+}
+
+// Finds the chunk by address, which walks the chunks but not the elements.
+template <typename T, umm N>
+void remove(Chunked_List<T, N>* list, T* element)
+{
+    for (List_Chunk<T, N>* chunk = list->head; chunk; chunk = chunk->next)
+    {
+        if (element >= chunk->items && element < chunk->items + chunk->count)
+        {
+            remove(list, chunk, element - chunk->items);
+            return;
+        }
+    }
+
+    DebugAssert(!"The element is not in the list.");
+}
+
+template <typename T, umm N>
+void clear(Chunked_List<T, N>* list)
+{
+    if (list->tail)
+    {
+        list->tail->next = list->free_chunks;
+        list->free_chunks = list->head;
+    }
+
+    list->head  = NULL;
+    list->tail  = NULL;
+    list->count = 0;
+}
+
+template <typename T, umm N>
+struct Chunked_List_Iterator
+{
+    List_Chunk<T, N>* chunk;
+    umm index;
+
+    inline bool operator!=(Chunked_List_Iterator<T, N> other) { return chunk != other.chunk || index != other.index; }
+    inline T*   operator* () { return &chunk->items[index]; }
+    inline void operator++()
+    {
+        if (++index == chunk->count)
+        {
+            chunk = chunk->next;
+            index = 0;
+        }
+    }
+};
+
+template <typename T, umm N>
+inline Chunked_List_Iterator<T, N> begin(Chunked_List<T, N>& list) { return { list.head, 0 }; }
+
+template <typename T, umm N>
+inline Chunked_List_Iterator<T, N> end(Chunked_List<T, N>& list) { return { NULL, 0 }; }
+
+
+
+
+//
+//
+// -- string utility
+//
+//
+
+
+//
+// Memory, character and C-style string utilities.
+//
+
+
+void copy(void* to, const void* from, umm length);
+void move(void* to, void* from, umm length);
+bool compare(const void* m1, const void* m2, umm length);
+umm find_mismatch(const void* m1, const void* m2, umm length);  // Index of the first byte that differs, or length if none does.
+
+// For heap arrays that grow with realloc: makes room for at least 'needed' elements,
+// doubling the capacity (at least 64). Returns the possibly moved array.
+void* grow_array(void* array, umm* capacity, umm needed, umm element_size);
+
+template <typename T>
+inline T* grow(T* array, umm* capacity, umm needed)
+{
+    if (needed <= *capacity)
+        return array;
+    return (T*) grow_array(array, capacity, needed, sizeof(T));
+}
+
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+inline u16 endian_swap16(u16 value)
+{
+#ifdef _MSC_VER
+    return _byteswap_ushort(value);
+#else
+    return __builtin_bswap16(value);
+#endif
+}
+
+inline u32 endian_swap32(u32 value)
+{
+#ifdef _MSC_VER
+    return _byteswap_ulong(value);
+#else
+    return __builtin_bswap32(value);
+#endif
+}
+
+inline u64 endian_swap64(u64 value)
+{
+#ifdef _MSC_VER
+    return _byteswap_uint64(value);
+#else
+    return __builtin_bswap64(value);
+#endif
+}
+
+// Undefined for 0.
+inline u32 count_leading_zeros64(u64 value)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return 63 - (u32) index;
+#else
+    return (u32) __builtin_clzll(value);
+#endif
+}
+
+// Undefined for 0.
+inline u32 count_trailing_zeros64(u64 value)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return (u32) index;
+#else
+    return (u32) __builtin_ctzll(value);
+#endif
+}
+
+inline u32 count_set_bits64(u64 value)
+{
+#if defined(_MSC_VER) && defined(__AVX__)
+    return (u32) __popcnt64(value);  // Needs the POPCNT instruction, which every CPU with AVX has.
+#elif defined(_MSC_VER)
+    value = value - ((value >> 1) & 0x5555555555555555ull);
+    value = (value & 0x3333333333333333ull) + ((value >> 2) & 0x3333333333333333ull);
+    value = (value + (value >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return (u32)((value * 0x0101010101010101ull) >> 56);
+#else
+    return (u32) __builtin_popcountll(value);
+#endif
+}
+
+
+bool is_decimal_digit(u8 character);
+bool is_whitespace(u8 character);
+
+umm length_of_c_style_string(const char* c_string);
+umm length_of_c_style_string(const u16* c_string);
+
+
+//
+// 8-bit strings.
+// When treated as text, UTF-8 encoding is assumed.
+//
+
+
+struct String
+{
+    umm length;
+    u8* data;
+
+    inline u8& operator[](umm index)
+    {
+        DebugAssert(index < length);
+        return data[index];
+    }
+
+    inline operator bool()
+    {
+        return length != 0;
+    }
+};
+
+#define StringArgs(string)  (int)((string).length), (const char*)((string).data)
+
+
+inline String operator ""_s(const char* c_string, umm length)
+{
+    String result;
+    result.length = length;
+    result.data = (u8*) c_string;
+    return result;
+}
+
+
+String make_string(const char* c_string);  // Allocates.
+char* make_c_style_string(String string);  // Allocates.
+String wrap_string(const char* c_string);
+
+String allocate_string(Region* memory, String string);
+String clone_string(String string);  // Allocates.
+
+String concatenate(String first, String second, String third = {}, String fourth = {}, String fifth = {}, String sixth = {});  // Allocates.
+String substring(String string, umm start_index, umm length);
+String concatenate_adjacent_substrings(String left, String right, String parent);
+
+bool operator==(String lhs, String rhs);
+bool operator==(String lhs, const char* rhs);
+bool operator==(const char* lhs, String rhs);
+
+inline bool operator!=(String      lhs, String      rhs) { return !(lhs == rhs); }
+inline bool operator!=(String      lhs, const char* rhs) { return !(lhs == rhs); }
+inline bool operator!=(const char* lhs, String      rhs) { return !(lhs == rhs); }
+
+bool prefix_equals(String string, String prefix);
+bool suffix_equals(String string, String suffix);
+
+// Three-way comparisons. Negative if lhs comes first, positive if rhs comes first, 0 if they are equal.
+int compare(String lhs, String rhs);          // By bytes, a prefix comes before the longer string.
+int compare_natural(String lhs, String rhs);  // Runs of digits compare by value, so "frame2" comes before "frame10".
+
+// Sort in the order of compare and compare_natural. They use temporary memory.
+void sort(String* strings, umm count);
+void sort_natural(String* strings, umm count);
+
+constexpr umm NOT_FOUND = ~(umm) 0;
+
+umm find_first_occurance(String string, u8 of);
+umm find_first_occurance(String string, String of);
+umm find_first_occurance_of_any(String string, String any_of);
+
+umm find_last_occurance(String string, u8 of);
+umm find_last_occurance(String string, String of);
+umm find_last_occurance_of_any(String string, String any_of);
+
+void replace_all_occurances(String string, u8 what, u8 with_what);
+
+u32 compute_crc32(String data);
+
+
+//
+// String hashing.
+// hash_string gives the same value at compile time as at run time, so string literals can be
+// case labels, with one compare to rule out a collision:
+//
+//     switch (hash_string(key))
+//     {
+//         case "width"_h:  if (key == "width"_s)  ...; break;
+//         case "height"_h: if (key == "height"_s) ...; break;
+//     }
+//
+// Labels that collide don't compile, as duplicate cases.
+// String_Switch is a perfect hash table built at compile time. It maps each of its keys to its index,
+// with one hash, one table read and one compare:
+//
+//     static constexpr auto FIELDS = make_string_switch("width", "height", "class");
+//     switch (FIELDS.find(key))
+//     {
+//         case 0: ...  // width
+//         case 1: ...  // height
+//         case 2: ...  // class
+//         default: ... // Not a field we know.
+//     }
+//
+// The hash may change between versions, so don't store it.
+//
+
+
+constexpr u64 mix_hash(u64 hash, u64 word)
+{
+    hash = (hash ^ word) * 0xFF51AFD7ED558CCD;
+    return hash ^ (hash >> 32);
+}
+
+constexpr u64 finish_hash(u64 hash)
+{
+    hash *= 0xC4CEB9FE1A85EC53;
+    return hash ^ (hash >> 29);
+}
+
+// Hashes little-endian 8-byte words, then the remaining bytes zero-extended to a word.
+// This version goes a byte at a time so it works at compile time, hash_string reads whole words.
+constexpr u64 hash_bytes(const char* data, umm length, u64 seed = 0)
+{
+    u64 hash = seed ^ (length * 0x9E3779B97F4A7C15);
+    umm i = 0;
+    for (; i + 8 <= length; i += 8)
+    {
+        u64 word = 0;
+        for (umm j = 0; j < 8; j++)
+            word |= (u64)(u8) data[i + j] << (j * 8);
+        hash = mix_hash(hash, word);
+    }
+
+    u64 word = 0;
+    for (umm j = 0; i + j < length; j++)
+        word |= (u64)(u8) data[i + j] << (j * 8);
+    return finish_hash(mix_hash(hash, word));
+}
+
+u64 hash_string(String string, u64 seed = 0);
+
+constexpr u64 operator ""_h(const char* c_string, umm length)
+{
+    return hash_bytes(c_string, length);
+}
+
+
+// Large enough that a seed without collisions turns up after a few tries.
+constexpr umm get_string_switch_size(umm key_count)
+{
+    umm size = 8;
+    while (size < key_count * 4 || size < key_count * key_count / 8)
+        size *= 2;
+    return size;
+}
+
+// These have no definition. Reaching one while building a String_Switch at compile time fails the build.
+void string_switch_has_duplicate_keys();
+void string_switch_found_no_seed();
+
+template <umm N>
+struct String_Switch
+{
+    const char* keys[N];
+    umm lengths[N];
+    u64 seed;
+    u32 shift;
+    u16 slots[get_string_switch_size(N)];  // Key index + 1, or 0 for none.
+
+    // Returns the index of the key, or U32_MAX if it isn't one of the keys.
+    u32 find(String key) const
+    {
+        u32 index = slots[hash_string(key, seed) >> shift];
+        if (!index)
+            return U32_MAX;
+
+        index--;
+        if (key.length != lengths[index] || !compare(key.data, keys[index], key.length))
+            return U32_MAX;
+        return index;
+    }
+};
+
+// The keys have to be string literals, their lengths come from the array sizes.
+// A const char* doesn't match, so it can't be hashed as a pointer by mistake.
+template <umm... Sizes>
+constexpr String_Switch<sizeof...(Sizes)> make_string_switch(const char (&... literals)[Sizes])
+{
+    constexpr umm N = sizeof...(Sizes);
+    // The slot table grows with N^2 / 8, and past this GCC's default constexpr limit stops the seed search.
+    // 256 keys take 16 KB of slots and well under a second to build.
+    static_assert(N > 0 && N <= 256, "String_Switch needs between 1 and 256 keys.");
+
+    String_Switch<N> result = {};
+    const char* keys[] = { literals... };
+    umm lengths[] = { (Sizes - 1)... };
+    for (umm i = 0; i < N; i++)
+    {
+        result.keys[i] = keys[i];
+        result.lengths[i] = lengths[i];
+    }
+
+    for (umm i = 0; i < N; i++)
+    {
+        for (umm j = i + 1; j < N; j++)
+        {
+            if (lengths[i] != lengths[j])
+                continue;
+
+            umm at = 0;
+            while (at < lengths[i] && keys[i][at] == keys[j][at])
+                at++;
+            if (at == lengths[i])
+                string_switch_has_duplicate_keys();
+        }
+    }
+
+    constexpr umm size = get_string_switch_size(N);
+    result.shift = 64;
+    for (umm bit = 1; bit < size; bit *= 2)
+        result.shift--;
+
+    for (u64 seed = 1; ; seed++)
+    {
+        if (seed > 100000)
+            string_switch_found_no_seed();
+
+        for (umm slot = 0; slot < size; slot++)
+            result.slots[slot] = 0;
+
+        bool collided = false;
+        for (umm i = 0; i < N && !collided; i++)
+        {
+            umm slot = hash_bytes(keys[i], lengths[i], seed) >> result.shift;
+            if (result.slots[slot])
+                collided = true;
+            else
+                result.slots[slot] = (u16)(i + 1);
+        }
+
+        if (!collided)
+        {
+            result.seed = seed;
+            break;
+        }
+    }
+
+    return result;
+}
+
+
+//
+// Text reading utilities.
+//
+
+
+void consume(String* string, umm amount);
+void consume_whitespace(String* string);
+
+umm find_line_ending(String string);  // Same as find_first_occurance_of_any(string, "\n\r"_s), but looks at 64 bytes at a time.
+
+String consume_line(String* string);
+String consume_line_preserve_whitespace(String* string);
+String peek_line_preserve_whitespace(String string); // Doesn't modify string.
+String consume_until(String* string, u8 until_what);
+String consume_until(String* string, String until_what);
+String consume_until_any(String* string, String until_any_of);
+String consume_until_whitespace(String* string);
+
+String trim(String string);
+
+
+//
+// Number parsing utilities.
+// Leading whitespace is skipped, then as much of the string as forms a number is parsed and consumed.
+// On failure (no digits, or an integer that doesn't fit) false is returned and the string is left untouched.
+// The overloads taking String by value require the whole string (sans surrounding whitespace) to be a number.
+// Floats accept "inf", "infinity" and "nan", and overflow to infinity like strtod does.
+//
+
+
+bool parse_u64    (String* string, u64* result);
+bool parse_i64    (String* string, i64* result);
+bool parse_hex_u64(String* string, u64* result);  // Optional 0x prefix.
+bool parse_f32    (String* string, f32* result);
+bool parse_f64    (String* string, f64* result);
+
+bool parse_u64    (String string, u64* result);
+bool parse_i64    (String string, i64* result);
+bool parse_hex_u64(String string, u64* result);
+bool parse_f32    (String string, f32* result);
+bool parse_f64    (String string, f64* result);
+
+
+//
+// Binary reading utilities.
+//
+
+
+bool read_bytes(String* string, void* result, umm count);
+
+bool read_u8 (String* string, u8*  result);
+bool read_u16(String* string, u16* result);
+bool read_u32(String* string, u32* result);
+bool read_u64(String* string, u64* result);
+
+bool read_i8 (String* string, i8*  result);
+bool read_s16(String* string, i16* result);
+bool read_s32(String* string, i32* result);
+bool read_s64(String* string, i64* result);
+
+bool read_u16le(String* string, u16* result);
+bool read_u32le(String* string, u32* result);
+bool read_u64le(String* string, u64* result);
+
+bool read_u16be(String* string, u16* result);
+bool read_u32be(String* string, u32* result);
+bool read_u64be(String* string, u64* result);
+
+bool read_s16le(String* string, i16* result);
+bool read_s32le(String* string, i32* result);
+bool read_s64le(String* string, i64* result);
+
+bool read_s16be(String* string, i16* result);
+bool read_s32be(String* string, i32* result);
+bool read_s64be(String* string, i64* result);
+
+// Arrays. The bounds are checked once, and big endian values are swapped a vector at a time.
+bool read_array_u16le(String* string, u16* result, umm count);
+bool read_array_u32le(String* string, u32* result, umm count);
+bool read_array_u64le(String* string, u64* result, umm count);
+
+bool read_array_u16be(String* string, u16* result, umm count);
+bool read_array_u32be(String* string, u32* result, umm count);
+bool read_array_u64be(String* string, u64* result, umm count);
+
+// Zero copy: points the result into the string. Fails if the data isn't aligned for the type.
+bool view_array_u16le(String* string, const u16** result, umm count);
+bool view_array_u32le(String* string, const u32** result, umm count);
+bool view_array_u64le(String* string, const u64** result, umm count);
+
+// LEB128, as written by write_varint. Fails on truncated input, and on values that don't fit in 64 bits.
+bool read_varint(String* string, u64* result);
+bool read_svarint(String* string, i64* result);  // Zigzag encoded.
+
+
+// Zigzag maps signed integers to unsigned ones so that small magnitudes stay small: 0, -1, 1, -2... become 0, 1, 2, 3...
+inline u32 zigzag_encode32(i32 value) { return ((u32) value << 1) ^ (u32)(value >> 31); }
+inline u64 zigzag_encode64(i64 value) { return ((u64) value << 1) ^ (u64)(value >> 63); }
+inline i32 zigzag_decode32(u32 value) { return (i32)((value >> 1) ^ (0 - (value & 1))); }
+inline i64 zigzag_decode64(u64 value) { return (i64)((value >> 1) ^ (0 - (value & 1))); }
+
+
+//
+// File path utilities.
+// Convention: directory paths *don't* end with a trailing slash.
+//
+
+
+String get_file_name(String path);
+String get_file_name_without_extension(String path);
+
+String get_parent_directory_path(String path);
+
+
+//
+// 16-bit strings. These mostly exist for interfacing with Windows.
+// That's why conversion routines return null terminated strings, and why
+// we don't really support any operations on them.
+//
+
+
+struct String16
+{
+    umm length;
+    u16* data;
+
+    inline u16& operator[](umm index)
+    {
+        DebugAssert(index < length);
+        return data[index];
+    }
+
+    inline operator bool()
+    {
+        return length != 0;
+    }
+};
+
+String16 make_string16(const u16* c_string);    // Allocates. The returned string is null terminated.
+String16 convert_utf8_to_utf16(String string, Region* memory = temp);  // Allocates. The returned string is null terminated.
+String convert_utf16_to_utf8(String16 string, Region* memory = temp);  // Allocates. The returned string is null terminated.
+
+
+//
+// String building utilities.
+//
+
+
+// By default the buffer is on the heap, and grows with realloc.
+// Short strings are kept in inline_buffer and don't allocate at all; because string.data can
+// point into the builder itself, builders shouldn't be copied around.
+// If region is set, the buffer is allocated in that region instead, and grows in place
+// as long as it's the most recent allocation.
+
+struct String_Builder
+{
+    String string;  // Null terminated.
+    umm capacity;
+    Region* region;
+
+    u8 inline_buffer[48];
+};
+
+
+void free_string_builder(String_Builder* builder);
+void clear(String_Builder* builder);
+void reserve(String_Builder* builder, umm length);  // Makes room for a string of this length.
+void shrink_to_fit(String_Builder* builder);
+
+// Hands the built string over to the caller, and resets the builder.
+// Heap-backed builders return a malloc'd string (release it with free), region-backed
+// builders return a string in their region. The returned string is null terminated.
+String take_string(String_Builder* builder);
+
+void append(String_Builder* builder, const void* data, umm length);
+void insert(String_Builder* builder, umm at_offset, const void* data, umm length);
+void remove(String_Builder* builder, umm at_offset, umm length);
+
+
+inline void append(String_Builder* builder, String string)
+{
+    append(builder, string.data, string.length);
+}
+
+inline void append(String_Builder* builder, const char* c_string)
+{
+    append(builder, c_string, length_of_c_style_string(c_string));
+}
+
+
+inline void insert(String_Builder* builder, umm at_offset, String string)
+{
+    insert(builder, at_offset, string.data, string.length);
+}
+
+inline void insert(String_Builder* builder, umm at_offset, const char* c_string)
+{
+    insert(builder, at_offset, c_string, length_of_c_style_string(c_string));
+}
+
+//
+// Number formatting utilities.
+// These write straight into the builder's spare capacity.
+// Floats are written in the shortest form that parses back to the same value, switching to
+// exponent notation outside of [1e-6, 1e21), like JavaScript. Non-finite values are written as "inf", "-inf" and "nan".
+// The precision overloads write a fixed number of digits after the decimal point (at most 17),
+// correctly rounded; values too large for that fall back to the shortest form.
+//
+
+
+void append_u64    (String_Builder* builder, u64 value);
+void append_i64    (String_Builder* builder, i64 value);
+void append_hex_u64(String_Builder* builder, u64 value);  // Lowercase, no 0x prefix.
+void append_f32    (String_Builder* builder, f32 value);
+void append_f64    (String_Builder* builder, f64 value);
+void append_f32    (String_Builder* builder, f32 value, u32 precision);
+void append_f64    (String_Builder* builder, f64 value, u32 precision);
+
+
+//
+// Binary writing utilities, the counterpart of the binary reading utilities.
+// The String_Builder versions grow the builder as needed. In hot loops, reserve the room once with
+// begin_binary_write, write through the Binary_Writer without any checks, and commit with end_binary_write.
+// A Binary_Writer can also write into a fixed buffer, for example one allocated in a region.
+//
+
+
+struct Binary_Writer
+{
+    u8* start;
+    u8* cursor;
+    u8* end;  // Writing past this is a bug, it's only checked with DebugAssert.
+};
+
+
+Binary_Writer make_binary_writer(void* buffer, umm capacity);
+Binary_Writer make_binary_writer(Region* memory, umm capacity);
+
+// Reserves max_length bytes after the builder's string. Nothing else can be
+// appended to the builder until end_binary_write.
+Binary_Writer begin_binary_write(String_Builder* builder, umm max_length);
+void end_binary_write(String_Builder* builder, Binary_Writer* writer);
+
+
+inline String get_written(Binary_Writer* writer)
+{
+    String result;
+    result.length = writer->cursor - writer->start;
+    result.data = writer->start;
+    return result;
+}
+
+inline void write_bytes(Binary_Writer* writer, const void* data, umm count)
+{
+    DebugAssert(count <= (umm)(writer->end - writer->cursor));
+    memcpy(writer->cursor, data, count);
+    writer->cursor += count;
+}
+
+inline void write_u8   (Binary_Writer* writer, u8  value) { write_bytes(writer, &value, 1); }
+inline void write_u16le(Binary_Writer* writer, u16 value) { write_bytes(writer, &value, 2); }
+inline void write_u32le(Binary_Writer* writer, u32 value) { write_bytes(writer, &value, 4); }
+inline void write_u64le(Binary_Writer* writer, u64 value) { write_bytes(writer, &value, 8); }
+inline void write_u16be(Binary_Writer* writer, u16 value) { value = endian_swap16(value); write_bytes(writer, &value, 2); }
+inline void write_u32be(Binary_Writer* writer, u32 value) { value = endian_swap32(value); write_bytes(writer, &value, 4); }
+inline void write_u64be(Binary_Writer* writer, u64 value) { value = endian_swap64(value); write_bytes(writer, &value, 8); }
+
+// LEB128: 7 bits per byte, low bits first, the high bit is set on all but the last byte. At most 10 bytes.
+inline void write_varint(Binary_Writer* writer, u64 value)
+{
+    u8* cursor = writer->cursor;
+    while (value >= 0x80)
+    {
+        DebugAssert(cursor < writer->end);
+        *(cursor++) = (u8) value | 0x80;
+        value >>= 7;
+    }
+    DebugAssert(cursor < writer->end);
+    *(cursor++) = (u8) value;
+    writer->cursor = cursor;
+}
+
+inline void write_svarint(Binary_Writer* writer, i64 value)
+{
+    write_varint(writer, zigzag_encode64(value));
+}
+
+
+void write_bytes(String_Builder* builder, const void* data, umm count);
+void write_u8   (String_Builder* builder, u8  value);
+void write_u16le(String_Builder* builder, u16 value);
+void write_u32le(String_Builder* builder, u32 value);
+void write_u64le(String_Builder* builder, u64 value);
+void write_u16be(String_Builder* builder, u16 value);
+void write_u32be(String_Builder* builder, u32 value);
+void write_u64be(String_Builder* builder, u64 value);
+void write_varint(String_Builder* builder, u64 value);
+void write_svarint(String_Builder* builder, i64 value);
+
+
+//
+// Formatting utilities.
+// format(&builder, "box {} at ({}, {})"_s, index, x, y) appends the format string with each {}
+// replaced by the next argument. Placeholders can have a spec: {:x} writes integers in hex,
+// {:.3} writes floats with 3 digits after the decimal point. {{ and }} write literal braces.
+// Supported arguments are String, String16, C-style strings, characters, bools, integers, floats
+// and pointers. tprint() does the same, but returns the result allocated in temporary memory.
+//
+
+
+struct Format_Argument
+{
+    enum Kind: u8
+    {
+        STRING,
+        STRING16,
+        CHARACTER,
+        BOOL,
+        UNSIGNED,
+        SIGNED,
+        F32,
+        F64,
+        POINTER,
+    };
+
+    Kind kind;
+    union
+    {
+        String   string;
+        String16 string16;
+        u64      unsigned_value;
+        i64      signed_value;
+        f64      float_value;
+    };
+};
+
+void format_arguments(String_Builder* builder, String format_string, Format_Argument* arguments, umm argument_count);
+String tprint_arguments(String format_string, Format_Argument* arguments, umm argument_count);
+
+#define FormatArgument(Type, kind_name, member, Cast)                       \
+    inline Format_Argument format_argument(Type value)                      \
+    {                                                                       \
+        Format_Argument argument;                                           \
+        argument.kind = Format_Argument::kind_name;                         \
+        argument.member = Cast(value);                                      \
+        return argument;                                                    \
+    }
+
+FormatArgument(String,             STRING,    string,         )
+FormatArgument(String16,           STRING16,  string16,       )
+FormatArgument(const char*,        STRING,    string,         wrap_string)
+FormatArgument(char,               CHARACTER, unsigned_value, (u8))
+FormatArgument(bool,               BOOL,      unsigned_value, (u64))
+FormatArgument(unsigned char,      UNSIGNED,  unsigned_value, (u64))
+FormatArgument(unsigned short,     UNSIGNED,  unsigned_value, (u64))
+FormatArgument(unsigned int,       UNSIGNED,  unsigned_value, (u64))
+FormatArgument(unsigned long,      UNSIGNED,  unsigned_value, (u64))
+FormatArgument(unsigned long long, UNSIGNED,  unsigned_value, (u64))
+FormatArgument(signed char,        SIGNED,    signed_value,   (i64))
+FormatArgument(short,              SIGNED,    signed_value,   (i64))
+FormatArgument(int,                SIGNED,    signed_value,   (i64))
+FormatArgument(long,               SIGNED,    signed_value,   (i64))
+FormatArgument(long long,          SIGNED,    signed_value,   (i64))
+FormatArgument(float,              F32,       float_value,    (f64))
+FormatArgument(double,             F64,       float_value,    )
+FormatArgument(const void*,        POINTER,   unsigned_value, (umm))
+
+#undef FormatArgument
+
+template <typename... Args>
+void format(String_Builder* builder, String format_string, Args... args)
+{
+    Format_Argument arguments[sizeof...(Args) + 1] = { format_argument(args)... };
+    format_arguments(builder, format_string, arguments, sizeof...(Args));
+}
+
+template <typename... Args>
+String tprint(String format_string, Args... args)
+{
+    Format_Argument arguments[sizeof...(Args) + 1] = { format_argument(args)... };
+    return tprint_arguments(format_string, arguments, sizeof...(Args));
+}
@@ -0,0 +1,585 @@
+#include "compress.h"
+#include "stream.h"
+
+#include <stdlib.h>
+
+
+static constexpr u32 HASH_BITS = 14;
+static constexpr umm MIN_MATCH = 4;
+static constexpr umm MAX_OFFSET = 65535;
+
+// The format requires the last 5 bytes to be literals, and the last match to start at least 12 bytes before the end,
+// which is what lets the decompressor copy 16 bytes at a time most of the way.
+static constexpr umm LAST_LITERALS = 5;
+static constexpr umm MATCH_START_LIMIT = 12;
+
+static constexpr u32 FRAME_MAGIC = 0x315A4B4C;  // "LKZ1"
+static constexpr u32 STORED_BLOCK = 0x80000000;
+
+
+static inline u32 load_u32(const u8* data)
+{
+    u32 value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+static inline u64 load_u64(const u8* data)
+{
+    u64 value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+static inline u32 hash_sequence(u32 sequence)
+{
+    return (sequence * 2654435761u) >> (32 - HASH_BITS);
+}
+
+
+//
+// Compression.
+//
+
+
+// Lengths that don't fit in the token's 4 bits continue in bytes of 255 and a last byte under 255.
+static inline u8* write_length(u8* out, umm length)
+{
+    for (; length >= 255; length -= 255)
+        *(out++) = 255;
+    *(out++) = (u8) length;
+    return out;
+}
+
+static inline const u8* find_match_end(const u8* at, const u8* match, const u8* limit)
+{
+    while (at + 8 <= limit)
+    {
+        u64 difference = load_u64(at) ^ load_u64(match);
+        if (difference)
+            return at + count_trailing_zeros64(difference) / 8;
+        at += 8;
+        match += 8;
+    }
+
+    while (at < limit && *at == *match)
+    {
+        at++;
+        match++;
+    }
+    return at;
+}
+
+
+void compress(Binary_Writer* writer, String data)
+{
+    DebugAssert(writer->cursor + get_compressed_max_length(data.length) <= writer->end);
+    DebugAssert(data.length < U32_MAX);
+
+    const u8* base = data.data;
+    const u8* end = data.data + data.length;
+    const u8* in = base;
+    const u8* anchor = base;
+    u8* out = writer->cursor;
+
+    if (data.length > MATCH_START_LIMIT)
+    {
+        const u8* match_start_limit = end - MATCH_START_LIMIT;
+        const u8* match_end_limit = end - LAST_LITERALS;
+
+        // Positions of the last 4 byte sequences seen, by hash. Stale or colliding entries are
+        // caught by comparing the bytes.
+        u32 table[1 << HASH_BITS];
+        memset(table, 0, sizeof(table));
+
+        table[hash_sequence(load_u32(in))] = 0;
+        in++;
+
+        while (true)
+        {
+            // Look for a match, stepping further the longer nothing is found, so incompressible data goes by quickly.
+            const u8* match;
+            u32 attempts = 1 << 6;
+            while (true)
+            {
+                if (in > match_start_limit)
+                    goto last_literals;
+
+                u32 hash = hash_sequence(load_u32(in));
+                match = base + table[hash];
+                table[hash] = (u32)(in - base);
+                if ((umm)(in - match) <= MAX_OFFSET && load_u32(match) == load_u32(in))
+                    break;
+
+                in += attempts++ >> 6;
+            }
+
+            while (in > anchor && match > base && in[-1] == match[-1])
+            {
+                in--;
+                match--;
+            }
+
+            umm literal_length = in - anchor;
+            u8* token = out++;
+            if (literal_length >= 15)
+            {
+                *token = 15 << 4;
+                out = write_length(out, literal_length - 15);
+            }
+            else
+            {
+                *token = (u8)(literal_length << 4);
+            }
+            copy(out, anchor, literal_length);
+            out += literal_length;
+
+            while (true)
+            {
+                umm offset = in - match;
+                out[0] = (u8) offset;
+                out[1] = (u8)(offset >> 8);
+                out += 2;
+
+                const u8* match_end = find_match_end(in + MIN_MATCH, match + MIN_MATCH, match_end_limit);
+                umm match_length = match_end - in - MIN_MATCH;
+                if (match_length >= 15)
+                {
+                    *token |= 15;
+                    out = write_length(out, match_length - 15);
+                }
+                else
+                {
+                    *token |= (u8) match_length;
+                }
+
+                in = match_end;
+                anchor = in;
+                if (in > match_start_limit)
+                    goto last_literals;
+
+                table[hash_sequence(load_u32(in - 2))] = (u32)(in - 2 - base);
+
+                // Often another match starts right where this one ended, then there are no literals in between.
+                u32 hash = hash_sequence(load_u32(in));
+                match = base + table[hash];
+                table[hash] = (u32)(in - base);
+                if ((umm)(in - match) > MAX_OFFSET || load_u32(match) != load_u32(in))
+                    break;
+
+                token = out++;
+                *token = 0;
+            }
+
+            in++;
+        }
+    }
+
+last_literals:
+    umm literal_length = end - anchor;
+    if (literal_length >= 15)
+    {
+        *(out++) = 15 << 4;
+        out = write_length(out, literal_length - 15);
+    }
+    else
+    {
+        *(out++) = (u8)(literal_length << 4);
+    }
+    if (literal_length)
+        copy(out, anchor, literal_length);
+    out += literal_length;
+
+    writer->cursor = out;
+}
+
+
+void compress(String_Builder* builder, String data)
+{
+    Binary_Writer writer = begin_binary_write(builder, get_compressed_max_length(data.length));
+    compress(&writer, data);
+    end_binary_write(builder, &writer);
+}
+
+
+//
+// Decompression.
+//
+
+
+static inline bool read_length(const u8** at, const u8* end, umm* length)
+{
+    u8 byte;
+    do
+    {
+        if (*at >= end)
+            return false;
+        byte = *((*at)++);
+        *length += byte;
+    }
+    while (byte == 255);
+    return true;
+}
+
+
+// For a match that overlaps what it produces, the smallest multiple of its offset that is at least 8.
+// Copying from that far back repeats the same pattern, 8 bytes at a time.
+static const u8 REPEAT_DISTANCE[8] = { 0, 8, 8, 9, 8, 10, 12, 14 };
+
+
+bool decompress(String compressed, void* output, umm length)
+{
+    const u8* in = compressed.data;
+    const u8* in_end = compressed.data + compressed.length;
+    u8* out_start = (u8*) output;
+    u8* out = out_start;
+    u8* out_end = out_start + length;
+
+    while (true)
+    {
+        if (in >= in_end)
+            return false;
+        u8 token = *(in++);
+
+        // Most literal runs are short. When there is room to go past the end on both sides, copy 16 bytes
+        // without looking at the length. Otherwise check everything, and copy exactly.
+        umm literal_length = token >> 4;
+        if (literal_length != 15 && in_end - in >= 32 && out_end - out >= 32)
+        {
+            memcpy(out, in, 16);
+        }
+        else
+        {
+            if (literal_length == 15 && !read_length(&in, in_end, &literal_length))
+                return false;
+            if (literal_length > (umm)(in_end - in) || literal_length > (umm)(out_end - out))
+                return false;
+
+            if (literal_length + 16 <= (umm)(in_end - in) && literal_length + 16 <= (umm)(out_end - out))
+            {
+                for (umm i = 0; i < literal_length; i += 16)
+                    memcpy(out + i, in + i, 16);
+            }
+            else
+            {
+                if (literal_length)
+                    copy(out, in, literal_length);
+
+                // The last sequence has only literals.
+                if (in + literal_length == in_end)
+                {
+                    out += literal_length;
+                    break;
+                }
+            }
+        }
+        in += literal_length;
+        out += literal_length;
+
+        if (in_end - in < 2)
+            return false;
+        umm offset = in[0] | ((umm) in[1] << 8);
+        in += 2;
+        if (!offset || offset > (umm)(out - out_start))
+            return false;
+
+        umm match_length = token & 15;
+        if (match_length == 15 && !read_length(&in, in_end, &match_length))
+            return false;
+        match_length += MIN_MATCH;
+        if (match_length > (umm)(out_end - out))
+            return false;
+
+        const u8* match = out - offset;
+        if (match_length + 16 <= (umm)(out_end - out))
+        {
+            if (offset >= 16)
+            {
+                for (umm i = 0; i < match_length; i += 16)
+                    memcpy(out + i, match + i, 16);
+            }
+            else if (offset >= 8)
+            {
+                for (umm i = 0; i < match_length; i += 8)
+                    memcpy(out + i, match + i, 8);
+            }
+            else
+            {
+                for (umm i = 0; i < 8; i++)
+                    out[i] = match[i];
+
+                umm distance = REPEAT_DISTANCE[offset];
+                for (umm i = 8; i < match_length; i += 8)
+                    memcpy(out + i, out + i - distance, 8);
+            }
+        }
+        else
+        {
+            for (umm i = 0; i < match_length; i++)
+                out[i] = match[i];
+        }
+        out += match_length;
+    }
+
+    return out == out_end;
+}
+
+
+bool decompress(String compressed, umm length, String* result, Region* memory)
+{
+    ZeroStruct(result);
+
+    u8* output = LK_RegionArray(memory, u8, length);
+    if (!decompress(compressed, output, length))
+        return false;
+
+    result->data = output;
+    result->length = length;
+    return true;
+}
+
+
+//
+// Framed format.
+//
+
+
+static void write_block(String_Builder* output, String data)
+{
+    Binary_Writer writer = begin_binary_write(output, 12 + get_compressed_max_length(data.length));
+    u8* header = writer.cursor;
+    writer.cursor += 12;
+
+    compress(&writer, data);
+    u32 stored_length = (u32)(writer.cursor - header - 12);
+    if (stored_length >= data.length)
+    {
+        writer.cursor = header + 12;
+        write_bytes(&writer, data.data, data.length);
+        stored_length = (u32) data.length | STORED_BLOCK;
+    }
+
+    Binary_Writer header_writer = make_binary_writer(header, 12);
+    write_u32le(&header_writer, stored_length);
+    write_u32le(&header_writer, (u32) data.length);
+    write_u32le(&header_writer, compute_crc32(data));
+
+    end_binary_write(output, &writer);
+}
+
+
+void begin_compressed_write(Compressed_Writer* writer, String_Builder* output)
+{
+    writer->output = output;
+    writer->block = (u8*) malloc(COMPRESSED_BLOCK_SIZE);
+    writer->block_length = 0;
+    write_u32le(output, FRAME_MAGIC);
+}
+
+
+void write_compressed(Compressed_Writer* writer, String data)
+{
+    while (data.length)
+    {
+        // Whole blocks are compressed straight from the data, without copying them to the block first.
+        if (!writer->block_length && data.length >= COMPRESSED_BLOCK_SIZE)
+        {
+            write_block(writer->output, substring(data, 0, COMPRESSED_BLOCK_SIZE));
+            consume(&data, COMPRESSED_BLOCK_SIZE);
+            continue;
+        }
+
+        umm amount = COMPRESSED_BLOCK_SIZE - writer->block_length;
+        if (amount > data.length)
+            amount = data.length;
+        copy(writer->block + writer->block_length, data.data, amount);
+        writer->block_length += amount;
+        consume(&data, amount);
+
+        if (writer->block_length == COMPRESSED_BLOCK_SIZE)
+        {
+            String block = { writer->block_length, writer->block };
+            write_block(writer->output, block);
+            writer->block_length = 0;
+        }
+    }
+}
+
+
+void end_compressed_write(Compressed_Writer* writer)
+{
+    if (writer->block_length)
+    {
+        String block = { writer->block_length, writer->block };
+        write_block(writer->output, block);
+    }
+
+    write_u32le(writer->output, 0);
+    write_u32le(writer->output, 0);
+    write_u32le(writer->output, 0);
+
+    free(writer->block);
+    ZeroStruct(writer);
+}
+
+
+void write_compressed_frame(String_Builder* output, String data)
+{
+    Compressed_Writer writer;
+    begin_compressed_write(&writer, output);
+    write_compressed(&writer, data);
+    end_compressed_write(&writer);
+}
+
+
+struct Block_Header
+{
+    u32 stored_length;
+    u32 length;
+    u32 crc;
+    bool is_stored;
+    bool is_end;
+};
+
+static bool read_block_header(String* input, Block_Header* header)
+{
+    u32 stored_length;
+    if (!read_u32le(input, &stored_length) ||
+        !read_u32le(input, &header->length) ||
+        !read_u32le(input, &header->crc))
+        return false;
+
+    header->is_end = !stored_length && !header->length && !header->crc;
+    header->is_stored = (stored_length & STORED_BLOCK) != 0;
+    header->stored_length = stored_length & ~STORED_BLOCK;
+    if (header->is_end)
+        return true;
+
+    if (header->length > COMPRESSED_BLOCK_SIZE || !header->length)
+        return false;
+    if (header->is_stored && header->stored_length != header->length)
+        return false;
+    return header->stored_length < header->length || header->is_stored;
+}
+
+
+bool read_compressed_frame(String frame, String* result, Region* memory)
+{
+    ZeroStruct(result);
+    if (!begin_compressed_read(&frame))
+        return false;
+
+    // Add up the lengths first, so the result is allocated once.
+    umm total_length = 0;
+    String at = frame;
+    while (true)
+    {
+        Block_Header header;
+        if (!read_block_header(&at, &header))
+            return false;
+        if (header.is_end)
+            break;
+        if (header.stored_length > at.length)
+            return false;
+
+        consume(&at, header.stored_length);
+        total_length += header.length;
+    }
+
+    u8* output = LK_RegionArray(memory, u8, total_length);
+    u8* out = output;
+    while (true)
+    {
+        Block_Header header;
+        read_block_header(&frame, &header);
+        if (header.is_end)
+            break;
+
+        String stored = substring(frame, 0, header.stored_length);
+        consume(&frame, header.stored_length);
+
+        if (header.is_stored)
+            copy(out, stored.data, stored.length);
+        else if (!decompress(stored, out, header.length))
+            return false;
+
+        String block = { header.length, out };
+        if (compute_crc32(block) != header.crc)
+            return false;
+        out += header.length;
+    }
+
+    result->data = output;
+    result->length = total_length;
+    return true;
+}
+
+
+bool begin_compressed_read(String* input)
+{
+    u32 magic;
+    return read_u32le(input, &magic) && magic == FRAME_MAGIC;
+}
+
+
+bool read_compressed_block(String* input, String* block, Region* memory)
+{
+    ZeroStruct(block);
+
+    String at = *input;
+    Block_Header header;
+    if (!read_block_header(&at, &header))
+        return false;
+
+    if (!header.is_end)
+    {
+        if (header.stored_length > at.length)
+            return false;
+
+        String stored = substring(at, 0, header.stored_length);
+        consume(&at, header.stored_length);
+
+        if (header.is_stored)
+            *block = stored;
+        else if (!decompress(stored, header.length, block, memory))
+            return false;
+
+        if (compute_crc32(*block) != header.crc)
+            return false;
+    }
+
+    *input = at;
+    return true;
+}
+
+
+bool begin_compressed_read(Stream_Reader* reader)
+{
+    return ensure(reader, 4) && begin_compressed_read(&reader->available);
+}
+
+
+bool read_compressed_block(Stream_Reader* reader, String* block, Region* memory)
+{
+    ZeroStruct(block);
+
+    Block_Header header;
+    if (!ensure(reader, 12) || !read_block_header(&reader->available, &header))
+        return false;
+    if (header.is_end)
+        return true;
+
+    // The bytes in 'available' are only valid until the next ensure, so stored blocks are copied too.
+    if (!ensure(reader, header.stored_length))
+        return false;
+
+    String stored = substring(reader->available, 0, header.stored_length);
+    consume(&reader->available, header.stored_length);
+
+    if (header.is_stored)
+        *block = allocate_string(memory, stored);
+    else if (!decompress(stored, header.length, block, memory))
+        return false;
+
+    return compute_crc32(*block) == header.crc;
+}
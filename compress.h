@@ -0,0 +1,88 @@
+#pragma once
+
+/*
+ *
+ * -- fast compression
+ *
+ * LZ77 compression in the LZ4 block format: a greedy compressor with a single hash table, and a
+ * decompressor that mostly copies 16 bytes at a time. It doesn't compress as well as zlib, but it
+ * decompresses several times faster than a disk can read, so compressed files load faster than
+ * raw ones.
+ *
+ * compress / decompress work on single buffers. The caller has to keep the original length:
+ *
+ *     compress(&builder, data);
+ *     ...
+ *     if (!decompress(compressed, original_length, &data, &memory))
+ *         ...
+ *
+ * The framed format is for files and anything written a piece at a time. The data is split into
+ * blocks of COMPRESSED_BLOCK_SIZE, each with its lengths and the compute_crc32 of its contents:
+ *
+ *     Compressed_Writer writer;
+ *     begin_compressed_write(&writer, &builder);
+ *     write_compressed(&writer, header);
+ *     write_compressed(&writer, annotations);
+ *     end_compressed_write(&writer);
+ *
+ * Frames can be read whole with read_compressed_frame, or block by block from a String or a
+ * Stream_Reader, which is how large caches are loaded without holding them in memory twice.
+ *
+ */
+
+#include "common.h"
+
+
+constexpr umm COMPRESSED_BLOCK_SIZE = 64 * 1024;
+
+
+// The most bytes compressing 'length' bytes can take, when the data doesn't compress at all.
+inline umm get_compressed_max_length(umm length)
+{
+    return length + length / 255 + 16;
+}
+
+
+// A Binary_Writer needs room for get_compressed_max_length bytes. Inputs must be smaller than 4 GB.
+void compress(Binary_Writer* writer, String data);
+void compress(String_Builder* builder, String data);
+
+// Returns false if the data is corrupt, or doesn't decompress to exactly 'length' bytes.
+bool decompress(String compressed, void* output, umm length);
+bool decompress(String compressed, umm length, String* result, Region* memory = temp);
+
+
+//
+// Framed format.
+// The frame starts with a 4 byte magic, then each block has a 12 byte header: the stored length,
+// with the high bit set if the block is stored uncompressed, the original length and the CRC-32
+// of the original bytes. A header of zeros ends the frame.
+//
+
+
+struct Compressed_Writer
+{
+    String_Builder* output;
+    u8* block;  // Heap allocated, COMPRESSED_BLOCK_SIZE bytes.
+    umm block_length;
+};
+
+void begin_compressed_write(Compressed_Writer* writer, String_Builder* output);
+void write_compressed(Compressed_Writer* writer, String data);
+void end_compressed_write(Compressed_Writer* writer);  // Writes the last block and the end of the frame.
+
+void write_compressed_frame(String_Builder* output, String data);
+
+
+// Returns false if the frame is corrupt or a checksum doesn't match.
+bool read_compressed_frame(String frame, String* result, Region* memory = temp);
+
+// Block by block. read_compressed_block returns false if the block is corrupt,
+// and an empty block at the end of the frame. Stored blocks read from a String point into it.
+bool begin_compressed_read(String* input);
+bool read_compressed_block(String* input, String* block, Region* memory = temp);
+
+// The Stream_Reader needs a max_token_size of at least COMPRESSED_BLOCK_SIZE, which the default is.
+struct Stream_Reader;
+bool begin_compressed_read(Stream_Reader* reader);
+bool read_compressed_block(Stream_Reader* reader, String* block, Region* memory = temp);
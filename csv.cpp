@@ -0,0 +1,186 @@
+#include "csv.h"
+#include "simd.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+void free_csv_reader(CSV_Reader* reader)
+{
+    free(reader->fields);
+    ZeroStruct(reader);
+}
+
+
+void set_input(CSV_Reader* reader, String chunk, bool is_last_chunk)
+{
+    reader->input = chunk;
+    reader->is_last_chunk = is_last_chunk;
+    reader->field_count = 0;
+    reader->record_start = 0;
+    reader->field_start = 0;
+    reader->block_start = 0;
+    reader->next_block = 0;
+    reader->structural = 0;
+    reader->quote_carry = 0;
+}
+
+
+umm get_consumed_length(CSV_Reader* reader)
+{
+    return reader->record_start;
+}
+
+
+// Classifies the next 64 bytes. Returns false at the end of input.
+static bool scan_next_block(CSV_Reader* reader)
+{
+    String input = reader->input;
+    umm at = reader->next_block;
+    if (at >= input.length)
+        return false;
+
+    umm remaining = input.length - at;
+    Block64 block = (remaining >= 64) ? load_block64(input.data + at)
+                                      : load_partial_block64(input.data + at, remaining, 0);
+
+    // Everything between a quote and the next one is quoted. An escaped quote ("")
+    // closes and immediately reopens the quotes, so it needs no special handling.
+    u64 quoted = prefix_xor(equal_mask(&block, '"')) ^ reader->quote_carry;
+    reader->quote_carry = (u64)((i64) quoted >> 63);
+
+    u64 structural = equal_mask(&block, reader->delimiter) | equal_mask(&block, '\n') | equal_mask(&block, '\r');
+    reader->structural = structural & ~quoted;
+    reader->block_start = at;
+    reader->next_block = at + 64;
+    return true;
+}
+
+
+static CSV_Field* add_field(CSV_Reader* reader)
+{
+    if (reader->field_count == reader->field_capacity)
+    {
+        umm new_capacity = reader->field_capacity;
+        if (!new_capacity) new_capacity = 16;
+        new_capacity = new_capacity + (new_capacity >> 1);
+
+        reader->fields = (CSV_Field*) realloc(reader->fields, new_capacity * sizeof(CSV_Field));
+        reader->field_capacity = new_capacity;
+    }
+
+    return &reader->fields[reader->field_count++];
+}
+
+static void set_field(CSV_Field* field, u8* start, u8* end)
+{
+    field->has_escaped_quote = false;
+    if (start < end && *start == '"')
+    {
+        start++;
+
+        u8* closing_quote = end;
+        while (closing_quote > start && closing_quote[-1] != '"')
+            closing_quote--;
+
+        if (closing_quote > start)
+        {
+            end = closing_quote - 1;
+            field->has_escaped_quote = memchr(start, '"', end - start) != NULL;
+        }
+    }
+
+    field->text.data = start;
+    field->text.length = end - start;
+}
+
+
+bool read_record(CSV_Reader* reader)
+{
+    if (!reader->delimiter)
+        reader->delimiter = ',';
+
+    reader->field_count = 0;
+
+    // Field pointers alias the reader, so the hot state is kept in locals.
+    u8* data = reader->input.data;
+    u8 delimiter = reader->delimiter;
+    umm field_start = reader->field_start;
+    umm record_start = reader->record_start;
+
+    while (true)
+    {
+        while (!reader->structural)
+        {
+            if (scan_next_block(reader))
+                continue;
+
+            // Out of input. The last record doesn't need a line ending.
+            umm length = reader->input.length;
+            if (!reader->is_last_chunk || (field_start >= length && !reader->field_count))
+            {
+                reader->field_count = 0;
+                reader->field_start = field_start;
+                reader->record_start = record_start;
+                return false;
+            }
+
+            set_field(add_field(reader), data + field_start, data + length);
+            reader->record_start = length;
+            reader->field_start = length;
+            return true;
+        }
+
+        u64 structural = reader->structural;
+        umm block_start = reader->block_start;
+        do
+        {
+            umm at = block_start + count_trailing_zeros64(structural);
+            structural = clear_lowest_bit(structural);
+
+            set_field(add_field(reader), data + field_start, data + at);
+            field_start = at + 1;
+
+            if (data[at] == delimiter)
+                continue;
+
+            // Line ending. Nothing between two of them is an empty line, which includes the "\n" after "\r".
+            bool empty_line = at == record_start;
+            record_start = at + 1;
+            if (empty_line)
+            {
+                reader->field_count = 0;
+                continue;
+            }
+
+            reader->structural = structural;
+            reader->field_start = field_start;
+            reader->record_start = record_start;
+            return true;
+        }
+        while (structural);
+
+        reader->structural = 0;
+    }
+}
+
+
+String unescape(CSV_Field field, Region* memory)
+{
+    if (!field.has_escaped_quote)
+        return field.text;
+
+    String result;
+    result.data = LK_RegionArray(memory, u8, field.text.length);
+    result.length = 0;
+
+    for (umm i = 0; i < field.text.length; i++)
+    {
+        u8 c = field.text.data[i];
+        result.data[result.length++] = c;
+        if (c == '"' && i + 1 < field.text.length && field.text.data[i + 1] == '"')
+            i++;
+    }
+
+    return result;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+/*
+ *
+ * -- CSV and TSV reading
+ *
+ * Quotes, delimiters and line endings are found 64 bytes at a time, and fields are returned
+ * as views into the input. Quoted fields may contain delimiters, line endings and escaped ("") quotes.
+ * Both "\n" and "\r\n" end a record, empty lines are skipped.
+ *
+ * Usage:
+ *     CSV_Reader reader = {};
+ *     reader.delimiter = '\t';  // Optional, ',' by default.
+ *     set_input(&reader, text);
+ *     while (read_record(&reader))
+ *         for (umm i = 0; i < reader.field_count; i++)
+ *             String value = unescape(reader.fields[i]);
+ *     free_csv_reader(&reader);
+ *
+ */
+
+#include "common.h"
+
+
+struct CSV_Field
+{
+    String text;            // Without the surrounding quotes.
+    bool has_escaped_quote;  // The text contains "" which unescape turns into ".
+};
+
+struct CSV_Reader
+{
+    u8 delimiter;  // 0 means ','
+
+    // The current record. Valid until the next read_record or set_input.
+    CSV_Field* fields;  // Heap allocated.
+    umm field_count;
+    umm field_capacity;
+
+    // Internal scanning state.
+    String input;
+    bool is_last_chunk;
+    umm record_start;
+    umm field_start;
+    umm block_start;
+    umm next_block;
+    u64 structural;   // Unvisited delimiters and line endings in the current block.
+    u64 quote_carry;  // All ones if the current block ended inside quotes.
+};
+
+
+void free_csv_reader(CSV_Reader* reader);
+
+// Input can be given in chunks. When a chunk isn't the last one, read_record stops at the first record
+// that isn't complete in it, and get_consumed_length tells where that record starts. The bytes from there
+// on have to be at the start of the next chunk. A single record must fit in a chunk.
+void set_input(CSV_Reader* reader, String chunk, bool is_last_chunk = true);
+umm get_consumed_length(CSV_Reader* reader);
+
+// Returns false when there are no more complete records.
+bool read_record(CSV_Reader* reader);
+
+// The field text with "" replaced with ". Doesn't copy when there is nothing to replace.
+String unescape(CSV_Field field, Region* memory = temp);
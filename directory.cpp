@@ -0,0 +1,388 @@
+#include "directory.h"
+
+#include <stdlib.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+#endif
+
+
+// Per thread state of a walk.
+struct Directory_Walker
+{
+    u32 flags;
+    Region* memory;     // Paths are allocated here.
+    Region own_memory;  // 'memory' of the extra threads, copied to the caller's region at the end.
+    Region scratch;
+
+    Directory_Entry* entries;
+    umm entry_count;
+    umm entry_capacity;
+    umm unreadable_count;
+
+    // Subdirectories found but not read yet.
+    String* pending;
+    umm pending_count;
+    umm pending_capacity;
+
+    u8* buffer;
+};
+
+// Shared by the threads of a parallel walk.
+struct Directory_Queue
+{
+    std::mutex mutex;
+    std::condition_variable condition;
+
+    // Protected by the mutex.
+    String* pending;
+    umm pending_count;
+    umm pending_capacity;
+    u32 busy_count;  // Threads reading a directory, which may add more.
+};
+
+
+static constexpr umm DIRECTORY_BUFFER_SIZE = 256 * 1024;
+
+
+static String join_path(Region* memory, String directory, String name)
+{
+    bool need_slash = name.length && directory.length && directory.data[directory.length - 1] != '/';
+
+    String result;
+    result.length = directory.length + need_slash + name.length;
+    result.data = LK_RegionArray(memory, u8, result.length + 1);
+
+    copy(result.data, directory.data, directory.length);
+    if (need_slash)
+        result.data[directory.length] = '/';
+    copy(result.data + directory.length + need_slash, name.data, name.length);
+    result.data[result.length] = 0;
+    return result;
+}
+
+
+static String copy_path(Region* memory, String path)
+{
+    return join_path(memory, path, {});
+}
+
+
+static Directory_Entry* add_entry(Directory_Walker* walker, String directory, String name, Directory_Entry::Kind kind)
+{
+    walker->entries = grow(walker->entries, &walker->entry_capacity, walker->entry_count + 1);
+
+    Directory_Entry* entry = &walker->entries[walker->entry_count++];
+    entry->path = join_path(walker->memory, directory, name);
+    entry->size = 0;
+    entry->modified_time = 0;
+    entry->kind = kind;
+
+    if (kind == Directory_Entry::DIRECTORY && (walker->flags & LIST_RECURSIVE))
+    {
+        walker->pending = grow(walker->pending, &walker->pending_capacity, walker->pending_count + 1);
+        walker->pending[walker->pending_count++] = entry->path;
+    }
+    return entry;
+}
+
+
+#ifdef _WIN32
+
+
+static bool is_directory(const char* path)
+{
+    String16 wide_path = convert_utf8_to_utf16(wrap_string(path));
+    DWORD attributes = GetFileAttributesW((LPCWSTR) wide_path.data);
+    return attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_DIRECTORY);
+}
+
+
+static void read_directory(Directory_Walker* walker, String directory)
+{
+    Scoped_Region_Cursor scope(&walker->scratch);
+
+    String pattern = join_path(&walker->scratch, directory, "*"_s);
+    String16 wide_pattern = convert_utf8_to_utf16(pattern, &walker->scratch);
+
+    WIN32_FIND_DATAW data;
+    HANDLE find = FindFirstFileExW((LPCWSTR) wide_pattern.data, FindExInfoBasic, &data,
+                                  FindExSearchNameMatch, NULL, FIND_FIRST_EX_LARGE_FETCH);
+    if (find == INVALID_HANDLE_VALUE)
+    {
+        walker->unreadable_count++;
+        return;
+    }
+    Defer(FindClose(find));
+
+    do
+    {
+        const WCHAR* name = data.cFileName;
+        if (name[0] == '.' && (!name[1] || (name[1] == '.' && !name[2])))
+            continue;
+
+        DWORD attributes = data.dwFileAttributes;
+        Directory_Entry::Kind kind = Directory_Entry::REGULAR_FILE;
+        if (attributes & FILE_ATTRIBUTE_DEVICE)             kind = Directory_Entry::OTHER;
+        else if (attributes & FILE_ATTRIBUTE_REPARSE_POINT) kind = Directory_Entry::SYMBOLIC_LINK;
+        else if (attributes & FILE_ATTRIBUTE_DIRECTORY)     kind = Directory_Entry::DIRECTORY;
+
+        String16 name16 = { wcslen(name), (u16*) name };
+        String name8 = convert_utf16_to_utf8(name16, &walker->scratch);
+        Directory_Entry* entry = add_entry(walker, directory, name8, kind);
+
+        // FILETIME counts 100 nanosecond intervals since 1601.
+        u64 time = ((u64) data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime;
+        entry->size = ((u64) data.nFileSizeHigh << 32) | data.nFileSizeLow;
+        entry->modified_time = ((i64) time - 116444736000000000) * 100;
+    }
+    while (FindNextFileW(find, &data));
+}
+
+
+#else
+
+
+static bool is_directory(const char* path)
+{
+    struct stat status;
+    return stat(path, &status) == 0 && S_ISDIR(status.st_mode);
+}
+
+
+static Directory_Entry::Kind get_kind(mode_t mode)
+{
+    if (S_ISREG(mode)) return Directory_Entry::REGULAR_FILE;
+    if (S_ISDIR(mode)) return Directory_Entry::DIRECTORY;
+    if (S_ISLNK(mode)) return Directory_Entry::SYMBOLIC_LINK;
+    return Directory_Entry::OTHER;
+}
+
+
+static void add_entry(Directory_Walker* walker, String directory, int descriptor, const char* name, u8 type)
+{
+    if (name[0] == '.' && (!name[1] || (name[1] == '.' && !name[2])))
+        return;
+
+    Directory_Entry::Kind kind = Directory_Entry::OTHER;
+    if (type == DT_REG) kind = Directory_Entry::REGULAR_FILE;
+    if (type == DT_DIR) kind = Directory_Entry::DIRECTORY;
+    if (type == DT_LNK) kind = Directory_Entry::SYMBOLIC_LINK;
+
+    // Some filesystems don't fill in d_type.
+    struct stat status;
+    bool have_status = false;
+    if (type == DT_UNKNOWN || (walker->flags & LIST_SIZE_AND_TIME))
+    {
+        have_status = fstatat(descriptor, name, &status, AT_SYMLINK_NOFOLLOW) == 0;
+        if (have_status)
+            kind = get_kind(status.st_mode);
+    }
+
+    Directory_Entry* entry = add_entry(walker, directory, wrap_string(name), kind);
+    if (have_status && (walker->flags & LIST_SIZE_AND_TIME))
+    {
+#ifdef __APPLE__
+        struct timespec time = status.st_mtimespec;
+#else
+        struct timespec time = status.st_mtim;
+#endif
+        entry->size = (u64) status.st_size;
+        entry->modified_time = (i64) time.tv_sec * 1000000000 + time.tv_nsec;
+    }
+}
+
+
+#ifdef __linux__
+
+// What getdents64 fills the buffer with. glibc only declares it since 2.30.
+struct Linux_Directory_Entry
+{
+    u64 inode;
+    i64 offset;
+    u16 record_length;
+    u8 type;
+    char name[1];
+};
+
+static void read_directory(Directory_Walker* walker, String directory)
+{
+    int descriptor = open((const char*) directory.data, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (descriptor < 0)
+    {
+        walker->unreadable_count++;
+        return;
+    }
+    Defer(close(descriptor));
+
+    while (true)
+    {
+        long read_size = syscall(SYS_getdents64, descriptor, walker->buffer, DIRECTORY_BUFFER_SIZE);
+        if (read_size <= 0)
+        {
+            if (read_size < 0)
+                walker->unreadable_count++;
+            return;
+        }
+
+        for (long offset = 0; offset < read_size;)
+        {
+            Linux_Directory_Entry* entry = (Linux_Directory_Entry*)(walker->buffer + offset);
+            offset += entry->record_length;
+            add_entry(walker, directory, descriptor, entry->name, entry->type);
+        }
+    }
+}
+
+#else
+
+static void read_directory(Directory_Walker* walker, String directory)
+{
+    DIR* handle = opendir((const char*) directory.data);
+    if (!handle)
+    {
+        walker->unreadable_count++;
+        return;
+    }
+    Defer(closedir(handle));
+
+    int descriptor = dirfd(handle);
+    while (struct dirent* entry = readdir(handle))
+        add_entry(walker, directory, descriptor, entry->d_name, entry->d_type);
+}
+
+#endif
+#endif
+
+
+static void walk_alone(Directory_Walker* walker)
+{
+    while (walker->pending_count)
+    {
+        String directory = walker->pending[--walker->pending_count];
+        read_directory(walker, directory);
+    }
+}
+
+
+static void walk_together(Directory_Walker* walker, Directory_Queue* queue)
+{
+    while (true)
+    {
+        String directory;
+        {
+            std::unique_lock<std::mutex> lock(queue->mutex);
+            queue->condition.wait(lock, [queue] { return queue->pending_count || !queue->busy_count; });
+
+            // Nothing is left, and nobody is reading a directory that could have more.
+            if (!queue->pending_count)
+                return;
+
+            directory = queue->pending[--queue->pending_count];
+            queue->busy_count++;
+        }
+
+        read_directory(walker, directory);
+
+        {
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            queue->pending = grow(queue->pending, &queue->pending_capacity, queue->pending_count + walker->pending_count);
+            copy(queue->pending + queue->pending_count, walker->pending, walker->pending_count * sizeof(String));
+            queue->pending_count += walker->pending_count;
+            queue->busy_count--;
+        }
+        walker->pending_count = 0;
+        queue->condition.notify_all();
+    }
+}
+
+
+bool list_directory(const char* path, Directory_Listing* listing, Region* memory, u32 flags, u32 thread_count)
+{
+    ZeroStruct(listing);
+    if (!is_directory(path))
+        return false;
+
+    if (thread_count < 1)
+        thread_count = 1;
+
+    Directory_Walker* walkers = (Directory_Walker*) calloc(thread_count, sizeof(Directory_Walker));
+    for (u32 i = 0; i < thread_count; i++)
+    {
+        Directory_Walker* walker = &walkers[i];
+        walker->flags = flags;
+        walker->memory = (i == 0) ? memory : &walker->own_memory;
+#ifndef _WIN32
+        walker->buffer = (u8*) malloc(DIRECTORY_BUFFER_SIZE);
+#endif
+    }
+
+    String root = copy_path(memory, wrap_string(path));
+
+    if (thread_count == 1)
+    {
+        walkers->pending = grow(walkers->pending, &walkers->pending_capacity, 1);
+        walkers->pending[walkers->pending_count++] = root;
+        walk_alone(walkers);
+    }
+    else
+    {
+        Directory_Queue queue = {};
+        queue.pending = grow(queue.pending, &queue.pending_capacity, 1);
+        queue.pending[queue.pending_count++] = root;
+
+        std::thread* threads = new std::thread[thread_count - 1];
+        for (u32 i = 1; i < thread_count; i++)
+            threads[i - 1] = std::thread(walk_together, &walkers[i], &queue);
+        walk_together(&walkers[0], &queue);
+        for (u32 i = 1; i < thread_count; i++)
+            threads[i - 1].join();
+
+        delete[] threads;
+        free(queue.pending);
+    }
+
+    umm count = 0;
+    for (u32 i = 0; i < thread_count; i++)
+        count += walkers[i].entry_count;
+
+    listing->entries = LK_RegionArray(memory, Directory_Entry, count);
+    for (u32 i = 0; i < thread_count; i++)
+    {
+        Directory_Walker* walker = &walkers[i];
+        Directory_Entry* entries = listing->entries + listing->count;
+        copy(entries, walker->entries, walker->entry_count * sizeof(Directory_Entry));
+
+        // The other threads' paths move to the caller's region.
+        if (walker->memory != memory)
+        {
+            for (umm j = 0; j < walker->entry_count; j++)
+                entries[j].path = copy_path(memory, entries[j].path);
+        }
+
+        listing->count += walker->entry_count;
+        listing->unreadable_count += walker->unreadable_count;
+
+        free(walker->entries);
+        free(walker->pending);
+        free(walker->buffer);
+        lk_region_free(&walker->own_memory);
+        lk_region_free(&walker->scratch);
+    }
+    free(walkers);
+
+    return true;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+/*
+ *
+ * -- listing directories
+ *
+ * list_directory collects the entries of a directory, and optionally of all its subdirectories,
+ * with their paths allocated in a region. On Linux directories are read with getdents64 into a
+ * large buffer and entry kinds come from d_type, so nothing is stat'ed unless sizes and times are
+ * asked for. On Windows FindFirstFileExW returns sizes and times along with the names anyway.
+ *
+ * With more than one thread, subdirectories are read in parallel. That helps most on network
+ * drives and cold caches, where each directory read waits on I/O.
+ * Entries come in no particular order. Paths are UTF-8.
+ *
+ */
+
+#include "common.h"
+
+
+enum: u32
+{
+    LIST_RECURSIVE     = 0x1,  // Include the contents of subdirectories. Symbolic links aren't followed.
+    LIST_SIZE_AND_TIME = 0x2,  // Fill in size and modified_time. On Linux this costs a stat per entry.
+};
+
+struct Directory_Entry
+{
+    enum Kind: u8
+    {
+        REGULAR_FILE,
+        DIRECTORY,
+        SYMBOLIC_LINK,  // Also other reparse points on Windows.
+        OTHER,
+    };
+
+    String path;        // The listed directory path, a slash and the path under it. Null terminated.
+    u64 size;           // With LIST_SIZE_AND_TIME.
+    i64 modified_time;  // With LIST_SIZE_AND_TIME. Nanoseconds since the Unix epoch.
+    Kind kind;
+};
+
+struct Directory_Listing
+{
+    Directory_Entry* entries;
+    umm count;
+    umm unreadable_count;  // Subdirectories that couldn't be read, their contents are missing.
+};
+
+
+// Returns false if the directory can't be read.
+bool list_directory(const char* path, Directory_Listing* listing, Region* memory = temp,
+                    u32 flags = LIST_RECURSIVE, u32 thread_count = 1);
@@ -0,0 +1,216 @@
+#include "file.h"
+
+
+#ifdef _WIN32
+
+#include <windows.h>
+
+
+static bool read_from_handle(HANDLE handle, File_Contents* file, Region* memory)
+{
+    String_Builder builder = {};
+    builder.region = memory;
+
+    while (true)
+    {
+        // Grow only when the room is running out, so the buffer grows geometrically.
+        // Every partial read growing it would copy everything read so far each time.
+        umm length = builder.string.length;
+        if (builder.capacity - length < 64 * 1024)
+            reserve(&builder, length + length / 2 + 64 * 1024);
+
+        DWORD read_size;
+        umm to_read = builder.capacity - length - 1;
+        if (to_read > 0x40000000)
+            to_read = 0x40000000;
+        if (!ReadFile(handle, builder.string.data + length, (DWORD) to_read, &read_size, NULL))
+        {
+            free_string_builder(&builder);
+            return false;
+        }
+
+        if (!read_size)
+            break;
+        builder.string.length += read_size;
+        builder.string.data[builder.string.length] = 0;
+    }
+
+    file->data = take_string(&builder);
+    file->is_mapped = false;
+    return true;
+}
+
+
+bool read_entire_file(const char* path, File_Contents* file, Region* memory, File_Access access)
+{
+    ZeroStruct(file);
+
+    DWORD flags = FILE_ATTRIBUTE_NORMAL;
+    if (access == FILE_ACCESS_SEQUENTIAL) flags |= FILE_FLAG_SEQUENTIAL_SCAN;
+    if (access == FILE_ACCESS_RANDOM)     flags |= FILE_FLAG_RANDOM_ACCESS;
+
+    String16 wide_path = convert_utf8_to_utf16(wrap_string(path));
+    HANDLE handle = CreateFileW((LPCWSTR) wide_path.data, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, flags, NULL);
+    if (handle == INVALID_HANDLE_VALUE)
+        return false;
+    Defer(CloseHandle(handle));
+
+    LARGE_INTEGER size;
+    if (GetFileType(handle) != FILE_TYPE_DISK || !GetFileSizeEx(handle, &size))
+        return read_from_handle(handle, file, memory);
+
+    if (!size.QuadPart)
+        return true;
+
+    // The view keeps the mapping alive, so both handles can be closed right away.
+    HANDLE mapping = CreateFileMappingW(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mapping)
+        return read_from_handle(handle, file, memory);
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!view)
+        return read_from_handle(handle, file, memory);
+
+    file->data.data = (u8*) view;
+    file->data.length = (umm) size.QuadPart;
+    file->is_mapped = true;
+
+    if (access == FILE_ACCESS_WILL_NEED)
+        advise(file, access);
+    return true;
+}
+
+
+void unmap(File_Contents* file)
+{
+    if (file->is_mapped)
+        UnmapViewOfFile(file->data.data);
+    ZeroStruct(file);
+}
+
+
+void advise(File_Contents* file, File_Access access, umm offset, umm length)
+{
+    if (!file->is_mapped || offset >= file->data.length)
+        return;
+    if (length > file->data.length - offset)
+        length = file->data.length - offset;
+
+    // Sequential and random access can only be hinted when the file is opened.
+#if _WIN32_WINNT >= 0x0602
+    if (access == FILE_ACCESS_WILL_NEED)
+    {
+        WIN32_MEMORY_RANGE_ENTRY range;
+        range.VirtualAddress = file->data.data + offset;
+        range.NumberOfBytes = length;
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+    }
+#endif
+}
+
+
+#else
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <errno.h>
+
+
+static bool read_from_descriptor(int descriptor, File_Contents* file, Region* memory)
+{
+    String_Builder builder = {};
+    builder.region = memory;
+
+    while (true)
+    {
+        // Grow only when the room is running out, so the buffer grows geometrically.
+        // Every partial read growing it would copy everything read so far each time.
+        umm length = builder.string.length;
+        if (builder.capacity - length < 64 * 1024)
+            reserve(&builder, length + length / 2 + 64 * 1024);
+
+        umm to_read = builder.capacity - length - 1;
+        ssize_t read_size = read(descriptor, builder.string.data + length, to_read);
+        if (read_size < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            free_string_builder(&builder);
+            return false;
+        }
+
+        if (!read_size)
+            break;
+        builder.string.length += read_size;
+        builder.string.data[builder.string.length] = 0;
+    }
+
+    file->data = take_string(&builder);
+    file->is_mapped = false;
+    return true;
+}
+
+
+bool read_entire_file(const char* path, File_Contents* file, Region* memory, File_Access access)
+{
+    ZeroStruct(file);
+
+    int descriptor = open(path, O_RDONLY | O_CLOEXEC);
+    if (descriptor < 0)
+        return false;
+    Defer(close(descriptor));
+
+    // Files like the ones in /proc report a size of 0, those get read.
+    struct stat status;
+    if (fstat(descriptor, &status) != 0 || !S_ISREG(status.st_mode) || !status.st_size)
+        return read_from_descriptor(descriptor, file, memory);
+
+    void* view = mmap(NULL, (size_t) status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    if (view == MAP_FAILED)
+        return read_from_descriptor(descriptor, file, memory);
+
+    file->data.data = (u8*) view;
+    file->data.length = (umm) status.st_size;
+    file->is_mapped = true;
+
+    if (access != FILE_ACCESS_NORMAL)
+        advise(file, access);
+    return true;
+}
+
+
+void unmap(File_Contents* file)
+{
+    if (file->is_mapped)
+        munmap(file->data.data, file->data.length);
+    ZeroStruct(file);
+}
+
+
+void advise(File_Contents* file, File_Access access, umm offset, umm length)
+{
+    if (!file->is_mapped || offset >= file->data.length)
+        return;
+    if (length > file->data.length - offset)
+        length = file->data.length - offset;
+
+    // madvise wants a page aligned address.
+    umm page_size = (umm) sysconf(_SC_PAGESIZE);
+    umm start = (umm)(file->data.data + offset);
+    umm aligned_start = start & ~(page_size - 1);
+    length += start - aligned_start;
+
+    int advice = MADV_NORMAL;
+    if (access == FILE_ACCESS_SEQUENTIAL) advice = MADV_SEQUENTIAL;
+    if (access == FILE_ACCESS_RANDOM)     advice = MADV_RANDOM;
+    if (access == FILE_ACCESS_WILL_NEED)  advice = MADV_WILLNEED;
+
+    madvise((void*) aligned_start, length, advice);
+}
+
+
+#endif
@@ -0,0 +1,44 @@
+#pragma once
+
+/*
+ *
+ * -- reading files
+ *
+ * read_entire_file maps the file into memory when it can, so the contents can be read
+ * without a copy and only the touched pages are ever loaded. Files that can't be mapped
+ * (pipes, devices, files without a known size) are read into a region instead.
+ * Paths are UTF-8.
+ *
+ */
+
+#include "common.h"
+
+
+enum File_Access: u8
+{
+    FILE_ACCESS_NORMAL,
+    FILE_ACCESS_SEQUENTIAL,  // Read ahead aggressively, drop pages behind.
+    FILE_ACCESS_RANDOM,      // Don't read ahead.
+    FILE_ACCESS_WILL_NEED,   // Start loading the pages now.
+};
+
+struct File_Contents
+{
+    String data;     // Not null terminated.
+    bool is_mapped;  // Otherwise the data was read into the region given to read_entire_file.
+};
+
+
+bool read_entire_file(const char* path, File_Contents* file, Region* memory = temp, File_Access access = FILE_ACCESS_NORMAL);
+
+// Releases the mapping, the data can't be used after this. Does nothing for data read into a region.
+void unmap(File_Contents* file);
+
+// Hints how a range of a mapped file is going to be read. Does nothing for data read into a region.
+void advise(File_Contents* file, File_Access access, umm offset, umm length);
+
+
+inline void advise(File_Contents* file, File_Access access)
+{
+    advise(file, access, 0, file->data.length);
+}
@@ -0,0 +1,612 @@
+#include "glob.h"
+#include "simd.h"
+
+#include <stdlib.h>
+
+
+// Compiling more states than this fails, patterns that need it are better matched some other way.
+static constexpr u32 GLOB_MAX_STATES = 65536;
+
+
+struct Byte_Set
+{
+    u64 bits[4];
+};
+
+static inline void add(Byte_Set* set, u8 byte)
+{
+    set->bits[byte >> 6] |= (u64) 1 << (byte & 63);
+}
+
+static inline bool contains(Byte_Set* set, u8 byte)
+{
+    return (set->bits[byte >> 6] >> (byte & 63)) & 1;
+}
+
+
+// One step of a pattern. Each item is also an NFA state, the one before the item is matched.
+// Matching the item moves to the next state. An item that repeats stays in its state instead,
+// and can move to the next one without reading anything.
+struct Glob_Item
+{
+    Byte_Set bytes;
+    bool repeats;
+    u8 skip;           // The state can also move this many items ahead without reading anything.
+    u32 pattern_index; // The last item of each alternative matches nothing and accepts this pattern.
+};
+
+struct Glob_Compiler
+{
+    bool ignore_case;
+    Byte_Set separators;
+    Byte_Set not_separators;
+    Byte_Set everything;
+
+    Glob_Item* items;
+    umm item_count;
+    umm item_capacity;
+};
+
+
+//
+// Parsing.
+//
+
+
+static Glob_Item* add_item(Glob_Compiler* compiler, Byte_Set bytes, bool repeats = false, u8 skip = 0)
+{
+    compiler->items = grow(compiler->items, &compiler->item_capacity, compiler->item_count + 1);
+
+    Glob_Item* item = &compiler->items[compiler->item_count++];
+    item->bytes = bytes;
+    item->repeats = repeats;
+    item->skip = skip;
+    item->pattern_index = U32_MAX;
+    return item;
+}
+
+
+static void add_character(Glob_Compiler* compiler, Byte_Set* set, u8 character)
+{
+    add(set, character);
+    if (compiler->ignore_case)
+    {
+        if (character >= 'a' && character <= 'z') add(set, character - 'a' + 'A');
+        if (character >= 'A' && character <= 'Z') add(set, character - 'A' + 'a');
+    }
+}
+
+
+// Returns the index of the ] that closes the [ at 'open', or NOT_FOUND.
+static umm find_bracket_end(String pattern, umm open)
+{
+    umm at = open + 1;
+    if (at < pattern.length && (pattern[at] == '!' || pattern[at] == '^'))
+        at++;
+
+    // A ] right at the start is part of the set.
+    if (at < pattern.length && pattern[at] == ']')
+        at++;
+
+    for (; at < pattern.length; at++)
+    {
+        if (pattern[at] == '\\')
+            at++;
+        else if (pattern[at] == ']')
+            return at;
+    }
+    return NOT_FOUND;
+}
+
+
+static bool parse_bracket(Glob_Compiler* compiler, String pattern, umm* at)
+{
+    umm end = find_bracket_end(pattern, *at);
+    if (end == NOT_FOUND)
+        return false;
+
+    umm i = *at + 1;
+    bool negated = pattern[i] == '!' || pattern[i] == '^';
+    if (negated)
+        i++;
+
+    Byte_Set set = {};
+    for (bool first = true; i < end; first = false)
+    {
+        u8 low = pattern[i++];
+        if (low == '\\')
+            low = pattern[i++];
+        else if (low == ']' && !first)
+            break;
+
+        u8 high = low;
+        if (i + 1 < end && pattern[i] == '-')
+        {
+            high = pattern[i + 1];
+            i += 2;
+            if (high == '\\')
+                high = pattern[i++];
+        }
+
+        for (u32 c = low; c <= high; c++)
+            add_character(compiler, &set, (u8) c);
+    }
+
+    for (u32 word = 0; word < 4; word++)
+    {
+        if (negated)
+            set.bits[word] = ~set.bits[word];
+        set.bits[word] &= compiler->not_separators.bits[word];
+    }
+
+    add_item(compiler, set);
+    *at = end + 1;
+    return true;
+}
+
+
+// Any run of characters ending with a slash, or nothing at all.
+static void add_directories(Glob_Compiler* compiler)
+{
+    // The first item doesn't match anything, it only goes either to the run or past the slash.
+    add_item(compiler, {}, true, 3);
+    add_item(compiler, compiler->everything, true);
+    add_item(compiler, compiler->separators);
+}
+
+
+// Adds the items of one alternative, after braces were expanded.
+static bool add_alternative(Glob_Compiler* compiler, String pattern, u32 pattern_index)
+{
+    umm first_item = compiler->item_count;
+    bool has_slash = false;
+
+    for (umm at = 0; at < pattern.length;)
+    {
+        u8 c = pattern[at];
+        if (c == '*')
+        {
+            if (at + 1 < pattern.length && pattern[at + 1] == '*')
+            {
+                if (at + 2 < pattern.length && pattern[at + 2] == '/')
+                {
+                    add_directories(compiler);
+                    has_slash = true;
+                    at += 3;
+                }
+                else
+                {
+                    add_item(compiler, compiler->everything, true);
+                    at += 2;
+                }
+            }
+            else
+            {
+                add_item(compiler, compiler->not_separators, true);
+                at += 1;
+            }
+        }
+        else if (c == '?')
+        {
+            add_item(compiler, compiler->not_separators);
+            at += 1;
+        }
+        else if (c == '[')
+        {
+            if (!parse_bracket(compiler, pattern, &at))
+                return false;
+        }
+        else if (c == '/')
+        {
+            add_item(compiler, compiler->separators);
+            has_slash = true;
+            at += 1;
+        }
+        else
+        {
+            if (c == '\\')
+            {
+                if (++at == pattern.length)
+                    return false;
+                c = pattern[at];
+            }
+
+            Byte_Set set = {};
+            add_character(compiler, &set, c);
+            add_item(compiler, set);
+            at += 1;
+        }
+    }
+
+    // Patterns without a slash match the file name, so they can start after any directories.
+    if (!has_slash)
+    {
+        umm pattern_end = compiler->item_count;
+        add_directories(compiler);
+
+        Glob_Item directories[3];
+        Glob_Item* items = compiler->items + first_item;
+        copy(directories, compiler->items + pattern_end, sizeof(directories));
+        move(items + 3, items, (pattern_end - first_item) * sizeof(Glob_Item));
+        copy(items, directories, sizeof(directories));
+    }
+
+    add_item(compiler, {})->pattern_index = pattern_index;
+    return true;
+}
+
+
+// Adds an alternative for each way the braces in the pattern can be expanded.
+static bool expand_braces(Glob_Compiler* compiler, String pattern, u32 pattern_index, Region* scratch)
+{
+    umm open = NOT_FOUND;
+    for (umm at = 0; at < pattern.length && open == NOT_FOUND; at++)
+    {
+        if (pattern[at] == '\\')
+            at++;
+        else if (pattern[at] == '[')
+        {
+            umm end = find_bracket_end(pattern, at);
+            if (end == NOT_FOUND)
+                return false;
+            at = end;
+        }
+        else if (pattern[at] == '{')
+            open = at;
+    }
+
+    if (open == NOT_FOUND)
+        return add_alternative(compiler, pattern, pattern_index);
+
+    // Split the contents at the commas that aren't in nested braces.
+    u32 depth = 0;
+    umm option_start = open + 1;
+    for (umm at = open + 1; at < pattern.length; at++)
+    {
+        u8 c = pattern[at];
+        if (c == '\\')
+        {
+            at++;
+            continue;
+        }
+
+        if (c == '[')
+        {
+            umm end = find_bracket_end(pattern, at);
+            if (end == NOT_FOUND)
+                return false;
+            at = end;
+        }
+        else if (c == '{')
+        {
+            depth++;
+        }
+        else if (c == '}' && depth)
+        {
+            depth--;
+        }
+        else if ((c == ',' || c == '}') && !depth)
+        {
+            String before = substring(pattern, 0, open);
+            String option = substring(pattern, option_start, at - option_start);
+
+            umm close = at;
+            while (c != '}')
+            {
+                // Find the end of the braces, to get what comes after them.
+                if (++close >= pattern.length)
+                    return false;
+
+                u8 d = pattern[close];
+                if (d == '\\')                   close++;
+                else if (d == '[')               close = find_bracket_end(pattern, close);
+                else if (d == '{')               depth++;
+                else if (d == '}' && depth)      depth--;
+                else if (d == '}')               break;
+
+                if (close == NOT_FOUND)
+                    return false;
+            }
+
+            String after = substring(pattern, close + 1, pattern.length - close - 1);
+            String expanded;
+            expanded.length = before.length + option.length + after.length;
+            expanded.data = LK_RegionArray(scratch, u8, expanded.length);
+            copy(expanded.data, before.data, before.length);
+            copy(expanded.data + before.length, option.data, option.length);
+            copy(expanded.data + before.length + option.length, after.data, after.length);
+
+            if (!expand_braces(compiler, expanded, pattern_index, scratch))
+                return false;
+
+            if (c == '}')
+                return true;
+            option_start = at + 1;
+        }
+    }
+
+    return false;
+}
+
+
+//
+// Building the DFA.
+//
+
+
+// The states are sets of items, as bit arrays of 'word_count' words each.
+struct Glob_Builder
+{
+    Glob_Item* items;
+    umm word_count;
+
+    u64* sets;
+    umm set_capacity;
+    u32 state_count;
+
+    u32* table;  // Open addressing, state index + 1, or 0 for empty.
+    u32 table_size;
+};
+
+
+static void close_over_skips(Glob_Builder* builder, u64* set)
+{
+    // Skips only go forward, so one pass in order follows chains of them.
+    for (umm word = 0; word < builder->word_count; word++)
+    {
+        for (u64 bits = set[word]; bits; bits = clear_lowest_bit(bits))
+        {
+            umm item = word * 64 + count_trailing_zeros64(bits);
+            Glob_Item* from = &builder->items[item];
+            umm targets[2] = { item + from->repeats, item + from->skip };
+            for (u32 i = 0; i < 2; i++)
+            {
+                umm target = targets[i];
+                if (target == item)
+                    continue;
+
+                set[target / 64] |= (u64) 1 << (target % 64);
+                if (target / 64 == word)
+                    bits |= (u64) 1 << (target % 64);
+            }
+        }
+    }
+}
+
+
+static u64 hash_set(u64* set, umm word_count)
+{
+    u64 hash = 0x9E3779B97F4A7C15;
+    for (umm i = 0; i < word_count; i++)
+    {
+        hash ^= set[i];
+        hash *= 0xFF51AFD7ED558CCD;
+        hash ^= hash >> 32;
+    }
+    return hash;
+}
+
+
+// Returns the state with this set, adding it if it's new. Returns U32_MAX if there are too many states.
+static u32 find_or_add_state(Glob_Builder* builder, u64* set)
+{
+    umm word_count = builder->word_count;
+    if (builder->state_count * 2 >= builder->table_size)
+    {
+        u32 new_size = builder->table_size ? builder->table_size * 2 : 1024;
+        u32* new_table = (u32*) calloc(new_size, sizeof(u32));
+        for (u32 state = 0; state < builder->state_count; state++)
+        {
+            u32 slot = (u32) hash_set(builder->sets + state * word_count, word_count) & (new_size - 1);
+            while (new_table[slot])
+                slot = (slot + 1) & (new_size - 1);
+            new_table[slot] = state + 1;
+        }
+
+        free(builder->table);
+        builder->table = new_table;
+        builder->table_size = new_size;
+    }
+
+    u32 slot = (u32) hash_set(set, word_count) & (builder->table_size - 1);
+    while (u32 entry = builder->table[slot])
+    {
+        if (memcmp(builder->sets + (entry - 1) * word_count, set, word_count * sizeof(u64)) == 0)
+            return entry - 1;
+        slot = (slot + 1) & (builder->table_size - 1);
+    }
+
+    if (builder->state_count == GLOB_MAX_STATES)
+        return U32_MAX;
+
+    u32 state = builder->state_count++;
+    builder->sets = grow(builder->sets, &builder->set_capacity, builder->state_count * word_count);
+    copy(builder->sets + state * word_count, set, word_count * sizeof(u64));
+    builder->table[slot] = state + 1;
+    return state;
+}
+
+
+bool compile_glob(Glob* glob, String* patterns, umm pattern_count, Region* memory, bool ignore_case)
+{
+    ZeroStruct(glob);
+
+    Glob_Compiler compiler = {};
+    compiler.ignore_case = ignore_case;
+    for (u32 c = 0; c < 256; c++)
+    {
+        bool is_separator = c == '/' || c == '\\';
+        add(is_separator ? &compiler.separators : &compiler.not_separators, (u8) c);
+        add(&compiler.everything, (u8) c);
+    }
+
+    Region scratch = {};
+    Defer(lk_region_free(&scratch));
+    Defer(free(compiler.items));
+
+    for (umm i = 0; i < pattern_count; i++)
+        if (!expand_braces(&compiler, patterns[i], (u32) i, &scratch))
+            return false;
+
+    // Split the bytes into classes, refining them by every item's set.
+    u8 classes[256] = {};
+    u32 class_count = 1;
+    for (umm i = 0; i < compiler.item_count; i++)
+    {
+        u32 new_class[512];
+        memset(new_class, 0xFF, sizeof(new_class));
+
+        u32 new_count = 0;
+        for (u32 c = 0; c < 256; c++)
+        {
+            u32 key = classes[c] * 2 + contains(&compiler.items[i].bytes, (u8) c);
+            if (new_class[key] == U32_MAX)
+                new_class[key] = new_count++;
+            classes[c] = (u8) new_class[key];
+        }
+        class_count = new_count;
+    }
+
+    u8 representative[256];
+    for (u32 c = 256; c-- > 0;)
+        representative[classes[c]] = (u8) c;
+
+    Glob_Builder builder = {};
+    builder.items = compiler.items;
+    builder.word_count = (compiler.item_count + 63) / 64;
+    Defer(free(builder.sets));
+    Defer(free(builder.table));
+
+    u64* set = LK_RegionArray(&scratch, u64, builder.word_count);
+
+    // State 0 is the empty set, where nothing can match anymore.
+    memset(set, 0, builder.word_count * sizeof(u64));
+    find_or_add_state(&builder, set);
+
+    for (umm i = 0; i < compiler.item_count; i++)
+    {
+        bool starts_alternative = (i == 0) || compiler.items[i - 1].pattern_index != U32_MAX;
+        if (starts_alternative)
+            set[i / 64] |= (u64) 1 << (i % 64);
+    }
+    close_over_skips(&builder, set);
+    u32 start = find_or_add_state(&builder, set);
+
+    u32* transitions = NULL;
+    umm transition_capacity = 0;
+    Defer(free(transitions));
+
+    // New states are added at the end, so walking up to the growing count visits them all.
+    for (u32 state = 0; state < builder.state_count; state++)
+    {
+        transitions = grow(transitions, &transition_capacity, (umm)(state + 1) * class_count);
+        for (u32 byte_class = 0; byte_class < class_count; byte_class++)
+        {
+            u8 byte = representative[byte_class];
+            memset(set, 0, builder.word_count * sizeof(u64));
+
+            u64* from = builder.sets + state * builder.word_count;
+            for (umm word = 0; word < builder.word_count; word++)
+            {
+                for (u64 bits = from[word]; bits; bits = clear_lowest_bit(bits))
+                {
+                    umm item = word * 64 + count_trailing_zeros64(bits);
+                    if (!contains(&compiler.items[item].bytes, byte))
+                        continue;
+
+                    umm target = compiler.items[item].repeats ? item : item + 1;
+                    set[target / 64] |= (u64) 1 << (target % 64);
+                }
+            }
+            close_over_skips(&builder, set);
+
+            u32 next = find_or_add_state(&builder, set);
+            if (next == U32_MAX)
+                return false;
+
+            transitions[state * class_count + byte_class] = next * class_count;
+        }
+    }
+
+    glob->state_count = builder.state_count;
+    glob->class_count = class_count;
+    copy(glob->classes, classes, sizeof(classes));
+    glob->start = start * class_count;
+
+    glob->transitions = LK_RegionArray(memory, u32, builder.state_count * class_count);
+    copy(glob->transitions, transitions, builder.state_count * class_count * sizeof(u32));
+
+    glob->accepted = LK_RegionArray(memory, u32, builder.state_count);
+    for (u32 state = 0; state < builder.state_count; state++)
+    {
+        u32 accepted = U32_MAX;
+        u64* state_set = builder.sets + state * builder.word_count;
+        for (umm word = 0; word < builder.word_count; word++)
+        {
+            for (u64 bits = state_set[word]; bits; bits = clear_lowest_bit(bits))
+            {
+                u32 pattern_index = compiler.items[word * 64 + count_trailing_zeros64(bits)].pattern_index;
+                if (pattern_index < accepted)
+                    accepted = pattern_index;
+            }
+        }
+        glob->accepted[state] = accepted;
+    }
+
+    return true;
+}
+
+
+u32 match_glob(Glob* glob, String path)
+{
+    // States are stored as offsets of their row in the transition table.
+    u32* transitions = glob->transitions;
+    u32 state = glob->start;
+    for (umm i = 0; i < path.length; i++)
+    {
+        state = transitions[state + glob->classes[path.data[i]]];
+        if (!state)
+            return U32_MAX;
+    }
+    return glob->accepted[state / glob->class_count];
+}
+
+
+void match_glob(Glob* glob, String* paths, umm count, u32* results)
+{
+    u32* transitions = glob->transitions;
+    u8* classes = glob->classes;
+
+    // Walks four paths at a time. Each step waits for the previous lookup,
+    // so four independent walks run almost as fast as one.
+    umm i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        String* group = paths + i;
+        umm common_length = group[0].length;
+        for (u32 j = 1; j < 4; j++)
+            if (group[j].length < common_length)
+                common_length = group[j].length;
+
+        // The dead state only leads to itself, so there is no need to stop early.
+        u32 states[4] = { glob->start, glob->start, glob->start, glob->start };
+        for (umm at = 0; at < common_length; at++)
+        {
+            states[0] = transitions[states[0] + classes[group[0].data[at]]];
+            states[1] = transitions[states[1] + classes[group[1].data[at]]];
+            states[2] = transitions[states[2] + classes[group[2].data[at]]];
+            states[3] = transitions[states[3] + classes[group[3].data[at]]];
+        }
+
+        for (u32 j = 0; j < 4; j++)
+        {
+            u32 state = states[j];
+            for (umm at = common_length; at < group[j].length && state; at++)
+                state = transitions[state + classes[group[j].data[at]]];
+            results[i + j] = glob->accepted[state / glob->class_count];
+        }
+    }
+
+    for (; i < count; i++)
+        results[i] = match_glob(glob, paths[i]);
+}
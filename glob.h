@@ -0,0 +1,65 @@
+#pragma once
+
+/*
+ *
+ * -- matching paths against glob patterns
+ *
+ * A set of patterns is compiled once into a DFA, after which matching a path is one table
+ * lookup per byte, no matter how many patterns there are:
+ *
+ *     Glob images;
+ *     String patterns[] = { "*.{jpg,jpeg,png}"_s, "labels/frame_*.json"_s };
+ *     compile_glob(&images, patterns, 2, &memory, true);
+ *     ...
+ *     if (matches(&images, entry->path))
+ *         ...
+ *
+ * Syntax:
+ *   *       any run of characters except slashes
+ *   **      any run of characters, including slashes. Together with a slash after it, it can also
+ *           match nothing, so that a pattern can mean "in this directory or any directory under it".
+ *   ?       any character except a slash
+ *   [a-z_]  any of the characters, [!...] or [^...] any character not listed. Never matches a slash.
+ *   {a,b}   either alternative. Alternatives can contain any of the above, and nest.
+ *   \       makes the next character literal.
+ *
+ * A slash in a pattern matches both slashes, like the path utilities in common.h do.
+ * Patterns without a slash are matched against the file name, like get_file_name would return it,
+ * so "*.jpg" matches "frames/0001.jpg". Patterns with a slash are matched against the whole path.
+ * Matching is on bytes, ignore_case only folds ASCII letters.
+ *
+ */
+
+#include "common.h"
+
+
+struct Glob
+{
+    u32 state_count;
+    u32 class_count;
+    u8 classes[256];     // Bytes that have the same transitions everywhere share a class.
+    u32* transitions;    // state_count * class_count. State 0 is the dead state.
+    u32* accepted;       // Per state, the index of the first pattern that matches there, or U32_MAX.
+    u32 start;
+};
+
+
+// Returns false if a pattern is malformed: unclosed [ or {, or a \ at the end.
+bool compile_glob(Glob* glob, String* patterns, umm pattern_count, Region* memory = temp, bool ignore_case = false);
+
+// Returns the index of the first pattern that matches the whole path, or U32_MAX.
+u32 match_glob(Glob* glob, String path);
+
+// The same for many paths. This is faster than matching them one by one, because it overlaps the work on several paths.
+void match_glob(Glob* glob, String* paths, umm count, u32* results);
+
+
+inline bool compile_glob(Glob* glob, String pattern, Region* memory = temp, bool ignore_case = false)
+{
+    return compile_glob(glob, &pattern, 1, memory, ignore_case);
+}
+
+inline bool matches(Glob* glob, String path)
+{
+    return match_glob(glob, path) != U32_MAX;
+}
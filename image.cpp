@@ -8,6 +8,7 @@
 #include "libraries/stb_image.h"
 
 #include "common.h"
+#include "file.h"
 #include "math.h"
 
 
@@ -70,7 +71,18 @@ Image make_image_from_file(const char* path, bool keep_pixel_data)
 {
 	Image image;
 
-	image.data = stbi_load(path, &image.width, &image.height, &image.channel_count, STBI_rgb_alpha);
+	// decode straight from the mapped file instead of letting stb do buffered reads
+	File_Contents file;
+	if (!read_entire_file(path, &file, temp, FILE_ACCESS_SEQUENTIAL) || file.data.length > 0x7FFFFFFF)
+	{
+		printf("Cant read image file for texture: \"%s\"\n", path);
+		unmap(&file);
+		return image;
+	}
+
+	image.data = stbi_load_from_memory(file.data.data, (int) file.data.length, &image.width, &image.height, &image.channel_count, STBI_rgb_alpha);
+	unmap(&file);
+
 	if (image.data == NULL)
 	{
 		printf("Cant load image file for texture: \"%s\"\n", path);
@@ -0,0 +1,515 @@
+#pragma once
+
+/*
+ *
+ * -- intrusive hash table and tree
+ *
+ * Keyed and ordered containers in the style of List(T, member): the links live inside the objects,
+ * so linking and unlinking never allocate and objects never move.
+ *
+ *     struct Box
+ *     {
+ *         u64 id;
+ *         Hash_Link<Box> by_id;
+ *         Tree_Link<Box> by_area;
+ *         ...
+ *     };
+ *
+ *     Hash_Table(Box, by_id) boxes_by_id;
+ *     init_hash_table(&boxes_by_id, &memory, expected_box_count);
+ *     link(&boxes_by_id, box, hash_u64(box->id));
+ *     Box* box = find(&boxes_by_id, hash_u64(id), [&](Box* box) { return box->id == id; });
+ *
+ *     Tree(Box, by_area) boxes_by_area = {};
+ *     link(&boxes_by_area, box, [](Box* a, Box* b) { return a->area < b->area; });
+ *     for (Box* box : boxes_by_area)
+ *         ...
+ *
+ * The hash table only needs memory for its buckets, which come from the caller or a Region. It never
+ * grows by itself: size it up front, or rehash when count gets larger than bucket_count.
+ * The tree is a red-black tree, so lookups, links and unlinks are O(log n) in the worst case.
+ * Equal objects are kept in the order they were linked.
+ *
+ */
+
+#include "common.h"
+
+
+
+//
+// Intrusive hash table.
+// Chained, with the full hash kept in the link so chains are walked without touching keys.
+//
+
+template <typename T>
+struct Hash_Link
+{
+    T* next;
+    u64 hash;
+};
+
+#define Hash_Table(T, member) Hash_Table_<T, &T::member>
+
+template <typename T, Hash_Link<T> T::* M>
+struct Hash_Table_
+{
+    T** buckets;
+    umm bucket_count;  // Power of two.
+    umm count;
+    u32 shift;
+};
+
+
+// For integer keys; strings have hash_string.
+inline u64 hash_u64(u64 value)
+{
+    return finish_hash(value);
+}
+
+template <typename T, Hash_Link<T> T::* M>
+inline umm get_bucket_index(Hash_Table_<T, M>* table, u64 hash)
+{
+    // Fibonacci hashing, so the top bits pick the bucket even if the hash is a plain integer.
+    return (umm)((hash * 0x9E3779B97F4A7C15ull) >> table->shift);
+}
+
+
+// bucket_count has to be a power of two, at least 2.
+template <typename T, Hash_Link<T> T::* M>
+void init_hash_table(Hash_Table_<T, M>* table, T** buckets, umm bucket_count)
+{
+    DebugAssert(bucket_count >= 2 && (bucket_count & (bucket_count - 1)) == 0);
+    memset(buckets, 0, bucket_count * sizeof(T*));
+
+    u32 shift = 64;
+    for (umm i = bucket_count; i > 1; i >>= 1)
+        shift--;
+
+    table->buckets      = buckets;
+    table->bucket_count = bucket_count;
+    table->count        = 0;
+    table->shift        = shift;
+}
+
+template <typename T, Hash_Link<T> T::* M>
+void init_hash_table(Hash_Table_<T, M>* table, Region* memory, umm expected_count)
+{
+    umm bucket_count = 16;
+    while (bucket_count < expected_count)
+        bucket_count *= 2;
+    init_hash_table(table, RegionArray(memory, T*, bucket_count), bucket_count);
+}
+
+
+template <typename T, Hash_Link<T> T::* M>
+inline void link(Hash_Table_<T, M>* table, T* object, u64 hash)
+{
+    T** bucket = &table->buckets[get_bucket_index(table, hash)];
+    (object->*M).next = *bucket;
+    (object->*M).hash = hash;
+    *bucket = object;
+    table->count++;
+}
+
+template <typename T, Hash_Link<T> T::* M>
+inline void unlink(Hash_Table_<T, M>* table, T* object)
+{
+    T** at = &table->buckets[get_bucket_index(table, (object->*M).hash)];
+    while (*at != object)
+    {
+        DebugAssert(*at);
+        at = &((*at)->*M).next;
+    }
+
+    *at = (object->*M).next;
+    table->count--;
+}
+
+// 'equal' is called as equal(T*) on objects with the same hash, and returns whether it's the one.
+template <typename T, Hash_Link<T> T::* M, typename Equal>
+inline T* find(Hash_Table_<T, M>* table, u64 hash, Equal&& equal)
+{
+    for (T* object = table->buckets[get_bucket_index(table, hash)]; object; object = (object->*M).next)
+        if ((object->*M).hash == hash && equal(object))
+            return object;
+    return NULL;
+}
+
+// The next object after 'object' with the same hash that 'equal' accepts, for tables with duplicate keys.
+template <typename T, Hash_Link<T> T::* M, typename Equal>
+inline T* find_next(Hash_Table_<T, M>* table, T* object, Equal&& equal)
+{
+    u64 hash = (object->*M).hash;
+    for (object = (object->*M).next; object; object = (object->*M).next)
+        if ((object->*M).hash == hash && equal(object))
+            return object;
+    return NULL;
+}
+
+// Moves every object to new buckets. The old buckets aren't touched after this.
+template <typename T, Hash_Link<T> T::* M>
+void rehash(Hash_Table_<T, M>* table, T** buckets, umm bucket_count)
+{
+    Hash_Table_<T, M> old = *table;
+    init_hash_table(table, buckets, bucket_count);
+
+    for (umm i = 0; i < old.bucket_count; i++)
+    {
+        T* object = old.buckets[i];
+        while (object)
+        {
+            T* next = (object->*M).next;
+            link(table, object, (object->*M).hash);
+            object = next;
+        }
+    }
+}
+
+template <typename T, Hash_Link<T> T::* M>
+void rehash(Hash_Table_<T, M>* table, Region* memory, umm bucket_count)
+{
+    rehash(table, RegionArray(memory, T*, bucket_count), bucket_count);
+}
+
+
+// Visits the objects in no particular order. Don't link or unlink while iterating.
+
+template <typename T, Hash_Link<T> T::* M>
+struct Hash_Table_Iterator
+{
+    T** bucket;
+    T** end;
+    T* current;
+
+    inline void skip_empty_buckets()
+    {
+        while (!current && bucket != end)
+            current = *(bucket++);
+    }
+
+    inline bool operator!=(Hash_Table_Iterator<T, M> other) { return current != other.current; }
+    inline void operator++() { current = (current->*M).next; skip_empty_buckets(); }
+    inline T*   operator* () { return current; }
+};
+
+template <typename T, Hash_Link<T> T::* M>
+inline Hash_Table_Iterator<T, M> begin(Hash_Table_<T, M>& table)
+{
+    Hash_Table_Iterator<T, M> it = { table.buckets, table.buckets + table.bucket_count, NULL };
+    it.skip_empty_buckets();
+    return it;
+}
+
+template <typename T, Hash_Link<T> T::* M>
+inline Hash_Table_Iterator<T, M> end(Hash_Table_<T, M>& table) { return { NULL, NULL, NULL }; }
+
+
+
+//
+// Intrusive red-black tree.
+// The order is given by the caller on every link, so the same object can be in several trees
+// with different orders. A zeroed Tree_ is an empty tree.
+//
+
+template <typename T>
+struct Tree_Link
+{
+    T* parent;
+    T* child[2];  // Left and right.
+    bool red;
+};
+
+#define Tree(T, member) Tree_<T, &T::member>
+
+template <typename T, Tree_Link<T> T::* M>
+struct Tree_
+{
+    T* root;
+    umm count;
+};
+
+
+// The last object down 'side' from 'object', 0 for left and 1 for right.
+template <typename T, Tree_Link<T> T::* M>
+inline T* get_outermost(T* object, int side)
+{
+    if (object)
+        while ((object->*M).child[side])
+            object = (object->*M).child[side];
+    return object;
+}
+
+// The previous or next object in order, NULL past the ends.
+template <typename T, Tree_Link<T> T::* M>
+inline T* get_adjacent(T* object, int side)
+{
+    if ((object->*M).child[side])
+        return get_outermost<T, M>((object->*M).child[side], !side);
+
+    T* parent = (object->*M).parent;
+    while (parent && (parent->*M).child[side] == object)
+    {
+        object = parent;
+        parent = (parent->*M).parent;
+    }
+    return parent;
+}
+
+template <typename T, Tree_Link<T> T::* M> inline T* get_first(Tree_<T, M>* tree)  { return get_outermost<T, M>(tree->root, 0); }
+template <typename T, Tree_Link<T> T::* M> inline T* get_last (Tree_<T, M>* tree)  { return get_outermost<T, M>(tree->root, 1); }
+template <typename T, Tree_Link<T> T::* M> inline T* get_next (Tree_<T, M>*, T* object) { return get_adjacent<T, M>(object, 1); }
+template <typename T, Tree_Link<T> T::* M> inline T* get_prev (Tree_<T, M>*, T* object) { return get_adjacent<T, M>(object, 0); }
+
+
+template <typename T, Tree_Link<T> T::* M>
+inline void replace_child(Tree_<T, M>* tree, T* parent, T* old_child, T* new_child)
+{
+    if (!parent)
+        tree->root = new_child;
+    else
+        (parent->*M).child[(parent->*M).child[1] == old_child] = new_child;
+}
+
+// Rotates 'object' down to 'side', and its child on the other side up in its place.
+template <typename T, Tree_Link<T> T::* M>
+void rotate(Tree_<T, M>* tree, T* object, int side)
+{
+    Tree_Link<T>* link = &(object->*M);
+    T* riser = link->child[!side];
+    T* moved = (riser->*M).child[side];
+
+    link->child[!side] = moved;
+    if (moved)
+        (moved->*M).parent = object;
+
+    (riser->*M).parent = link->parent;
+    replace_child(tree, link->parent, object, riser);
+
+    (riser->*M).child[side] = object;
+    link->parent = riser;
+}
+
+template <typename T, Tree_Link<T> T::* M>
+inline bool is_red(T* object)
+{
+    return object && (object->*M).red;
+}
+
+
+// 'less' is called as less(T* a, T* b). Objects equal to ones already in the tree go after them.
+template <typename T, Tree_Link<T> T::* M, typename Less>
+void link(Tree_<T, M>* tree, T* object, Less&& less)
+{
+    T* parent = NULL;
+    int side = 0;
+    for (T* at = tree->root; at; at = (at->*M).child[side])
+    {
+        parent = at;
+        side = less(object, at) ? 0 : 1;
+    }
+
+    Tree_Link<T>* link = &(object->*M);
+    link->parent   = parent;
+    link->child[0] = NULL;
+    link->child[1] = NULL;
+    link->red      = true;
+
+    if (parent)
+        (parent->*M).child[side] = object;
+    else
+        tree->root = object;
+    tree->count++;
+
+    // Fix two reds in a row, going up.
+    while (true)
+    {
+        parent = (object->*M).parent;
+        if (!parent)
+        {
+            (object->*M).red = false;
+            break;
+        }
+        if (!(parent->*M).red)
+            break;
+
+        T* grandparent = (parent->*M).parent;  // A red parent is never the root.
+        side = ((grandparent->*M).child[1] == parent);
+        T* uncle = (grandparent->*M).child[!side];
+
+        if (is_red<T, M>(uncle))
+        {
+            (parent->*M).red = false;
+            (uncle->*M).red = false;
+            (grandparent->*M).red = true;
+            object = grandparent;
+            continue;
+        }
+
+        if ((parent->*M).child[!side] == object)
+        {
+            rotate(tree, parent, side);
+            parent = object;
+        }
+
+        rotate(tree, grandparent, !side);
+        (parent->*M).red = false;
+        (grandparent->*M).red = true;
+        break;
+    }
+}
+
+template <typename T, Tree_Link<T> T::* M>
+void unlink(Tree_<T, M>* tree, T* object)
+{
+    // Find a node with at most one child to take out: the object itself, or its successor.
+    Tree_Link<T>* link = &(object->*M);
+    T* removed = object;
+    if (link->child[0] && link->child[1])
+        removed = get_outermost<T, M>(link->child[1], 0);
+
+    Tree_Link<T>* removed_link = &(removed->*M);
+    T* child  = removed_link->child[removed_link->child[0] ? 0 : 1];
+    T* parent = removed_link->parent;
+    bool removed_red = removed_link->red;
+
+    if (child)
+        (child->*M).parent = parent;
+    replace_child(tree, parent, removed, child);
+
+    if (removed != object)
+    {
+        // The successor takes the object's place and color.
+        if (parent == object)
+            parent = removed;
+
+        *removed_link = *link;
+        replace_child(tree, link->parent, object, removed);
+        for (int side = 0; side < 2; side++)
+            if (removed_link->child[side])
+                (removed_link->child[side]->*M).parent = removed;
+    }
+
+    tree->count--;
+    if (removed_red)
+        return;
+
+    // A black node is gone, so the 'child' side is one black short.
+    while (child != tree->root && !is_red<T, M>(child))
+    {
+        int side = ((parent->*M).child[1] == child);
+        T* sibling = (parent->*M).child[!side];  // Never NULL, the other side has more black nodes.
+
+        if ((sibling->*M).red)
+        {
+            (sibling->*M).red = false;
+            (parent->*M).red = true;
+            rotate(tree, parent, side);
+            sibling = (parent->*M).child[!side];
+        }
+
+        if (!is_red<T, M>((sibling->*M).child[0]) && !is_red<T, M>((sibling->*M).child[1]))
+        {
+            (sibling->*M).red = true;
+            child = parent;
+            parent = (parent->*M).parent;
+            continue;
+        }
+
+        if (!is_red<T, M>((sibling->*M).child[!side]))
+        {
+            ((sibling->*M).child[side]->*M).red = false;
+            (sibling->*M).red = true;
+            rotate(tree, sibling, !side);
+            sibling = (parent->*M).child[!side];
+        }
+
+        (sibling->*M).red = (parent->*M).red;
+        (parent->*M).red = false;
+        ((sibling->*M).child[!side]->*M).red = false;
+        rotate(tree, parent, side);
+        child = tree->root;
+    }
+
+    if (child)
+        (child->*M).red = false;
+}
+
+
+// 'compare' is called as compare(T*), and returns less than zero if the key goes before the object,
+// zero if they match, and more than zero if it goes after.
+
+// Any object matching the key, or NULL.
+template <typename T, Tree_Link<T> T::* M, typename Compare>
+T* find(Tree_<T, M>* tree, Compare&& compare)
+{
+    T* at = tree->root;
+    while (at)
+    {
+        auto order = compare(at);
+        if (order == 0)
+            return at;
+        at = (at->*M).child[order > 0];
+    }
+    return NULL;
+}
+
+// The first object that doesn't go before the key, or NULL.
+template <typename T, Tree_Link<T> T::* M, typename Compare>
+T* find_first_not_before(Tree_<T, M>* tree, Compare&& compare)
+{
+    T* result = NULL;
+    T* at = tree->root;
+    while (at)
+    {
+        if (compare(at) <= 0)
+        {
+            result = at;
+            at = (at->*M).child[0];
+        }
+        else
+        {
+            at = (at->*M).child[1];
+        }
+    }
+    return result;
+}
+
+// The first object that goes after the key, or NULL.
+template <typename T, Tree_Link<T> T::* M, typename Compare>
+T* find_first_after(Tree_<T, M>* tree, Compare&& compare)
+{
+    T* result = NULL;
+    T* at = tree->root;
+    while (at)
+    {
+        if (compare(at) < 0)
+        {
+            result = at;
+            at = (at->*M).child[0];
+        }
+        else
+        {
+            at = (at->*M).child[1];
+        }
+    }
+    return result;
+}
+
+
+// In order. Unlinking the current object while iterating isn't allowed, linking is.
+
+template <typename T, Tree_Link<T> T::* M>
+struct Tree_Iterator
+{
+    T* current;
+    inline bool operator!=(Tree_Iterator<T, M> other) { return current != other.current; }
+    inline void operator++() { current = get_adjacent<T, M>(current, 1); }
+    inline void operator--() { current = get_adjacent<T, M>(current, 0); }
+    inline T*   operator* () { return current; }
+};
+
+template <typename T, Tree_Link<T> T::* M>
+inline Tree_Iterator<T, M> begin(Tree_<T, M>& tree) { return { get_first(&tree) }; }
+
+template <typename T, Tree_Link<T> T::* M>
+inline Tree_Iterator<T, M> end(Tree_<T, M>& tree) { return { NULL }; }
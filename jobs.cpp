@@ -0,0 +1,276 @@
+#include "jobs.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+
+// Workers push and take at the bottom of their own deque, thieves take from the top.
+// This is the Chase-Lev deque with a fixed array: when it's full, the job runs right away instead.
+// Slots are written while a thief may read them, and the thief throws what it read away if its
+// compare-exchange on top fails, so the fields are relaxed atomics rather than plain values.
+
+constexpr i64 JOB_DEQUE_CAPACITY = 4096;
+constexpr umm CACHE_LINE_SIZE = 64;
+
+struct Job_Slot
+{
+    std::atomic<Job_Function*> function;
+    std::atomic<void*> user_data;
+    std::atomic<Job_Counter*> counter;
+};
+
+struct Job
+{
+    Job_Function* function;
+    void* user_data;
+    Job_Counter* counter;
+};
+
+struct Job_Worker
+{
+    // top and bottom are on separate cache lines, thieves only write top.
+    alignas(CACHE_LINE_SIZE) std::atomic<i64> top;
+    alignas(CACHE_LINE_SIZE) std::atomic<i64> bottom;
+    Job_Slot slots[JOB_DEQUE_CAPACITY];
+
+    u32 index;
+    u32 random;  // For picking whom to steal from.
+    std::thread thread;
+};
+
+static struct
+{
+    Job_Worker* workers;
+    u32 worker_count;
+
+    std::atomic<bool> quit;
+    std::atomic<u64> pushed;  // Counts pushes, a worker sleeps until it changes since its last failed search.
+    std::atomic<u32> sleeping;
+    std::mutex mutex;
+    std::condition_variable wake_up;
+} jobs;
+
+static thread_local Job_Worker* current_worker;
+
+
+//
+// Deque.
+//
+
+static bool push(Job_Worker* worker, Job job)
+{
+    i64 bottom = worker->bottom.load(std::memory_order_relaxed);
+    i64 top = worker->top.load(std::memory_order_acquire);
+    if (bottom - top >= JOB_DEQUE_CAPACITY)
+        return false;
+
+    Job_Slot* slot = &worker->slots[bottom & (JOB_DEQUE_CAPACITY - 1)];
+    slot->function .store(job.function,  std::memory_order_relaxed);
+    slot->user_data.store(job.user_data, std::memory_order_relaxed);
+    slot->counter  .store(job.counter,   std::memory_order_relaxed);
+
+    worker->bottom.store(bottom + 1, std::memory_order_release);
+    return true;
+}
+
+static void read_slot(Job_Worker* worker, i64 index, Job* job)
+{
+    Job_Slot* slot = &worker->slots[index & (JOB_DEQUE_CAPACITY - 1)];
+    job->function  = slot->function .load(std::memory_order_relaxed);
+    job->user_data = slot->user_data.load(std::memory_order_relaxed);
+    job->counter   = slot->counter  .load(std::memory_order_relaxed);
+}
+
+// Only called by the owner.
+static bool take(Job_Worker* worker, Job* job)
+{
+    i64 bottom = worker->bottom.load(std::memory_order_relaxed) - 1;
+    worker->bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    i64 top = worker->top.load(std::memory_order_relaxed);
+
+    if (top > bottom)
+    {
+        worker->bottom.store(bottom + 1, std::memory_order_relaxed);
+        return false;
+    }
+
+    read_slot(worker, bottom, job);
+    if (top < bottom)
+        return true;
+
+    // The last job, race the thieves for it.
+    bool won = worker->top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    worker->bottom.store(bottom + 1, std::memory_order_relaxed);
+    return won;
+}
+
+static bool steal(Job_Worker* worker, Job* job)
+{
+    i64 top = worker->top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    i64 bottom = worker->bottom.load(std::memory_order_acquire);
+    if (top >= bottom)
+        return false;
+
+    read_slot(worker, top, job);
+    return worker->top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+}
+
+
+//
+// Workers.
+//
+
+static bool find_job(Job_Worker* worker, Job* job)
+{
+    if (worker && take(worker, job))
+        return true;
+
+    // Steal, starting from a random worker so thieves spread out.
+    u32 start = 0;
+    if (worker)
+    {
+        worker->random ^= worker->random << 13;
+        worker->random ^= worker->random >> 17;
+        worker->random ^= worker->random << 5;
+        start = worker->random;
+    }
+
+    for (u32 i = 0; i < jobs.worker_count; i++)
+    {
+        Job_Worker* victim = &jobs.workers[(start + i) % jobs.worker_count];
+        if (victim != worker && steal(victim, job))
+            return true;
+    }
+    return false;
+}
+
+static void execute(Job job)
+{
+    job.function(job.user_data);
+    if (job.counter)
+        job.counter->pending.fetch_sub(1, std::memory_order_release);
+}
+
+static void run_worker(Job_Worker* worker)
+{
+    current_worker = worker;
+
+    u32 idle_rounds = 0;
+    while (!jobs.quit.load(std::memory_order_relaxed))
+    {
+        // Read before searching, so a push that the search missed still wakes this worker.
+        u64 pushed = jobs.pushed.load(std::memory_order_seq_cst);
+
+        Job job;
+        if (find_job(worker, &job))
+        {
+            execute(job);
+            idle_rounds = 0;
+            continue;
+        }
+
+        // Yield for a bit, then sleep until something new is pushed. Jobs that are queued but can't be
+        // stolen, like one its owner is about to take, don't keep the worker awake.
+        if (++idle_rounds < 64)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(jobs.mutex);
+        jobs.sleeping.fetch_add(1, std::memory_order_seq_cst);
+        jobs.wake_up.wait(lock, [&] { return jobs.quit.load() || jobs.pushed.load(std::memory_order_seq_cst) != pushed; });
+        jobs.sleeping.fetch_sub(1, std::memory_order_relaxed);
+        idle_rounds = 0;
+    }
+}
+
+
+void start_jobs(u32 thread_count)
+{
+    if (!thread_count)
+        thread_count = std::thread::hardware_concurrency();
+    if (!thread_count)
+        thread_count = 1;
+
+    jobs.workers = new Job_Worker[thread_count]();
+    jobs.worker_count = thread_count;
+    jobs.quit = false;
+    jobs.pushed = 0;
+    jobs.sleeping = 0;
+
+    for (u32 i = 0; i < thread_count; i++)
+    {
+        jobs.workers[i].index = i;
+        jobs.workers[i].random = 0x9E3779B9u * (i + 1);
+    }
+
+    current_worker = &jobs.workers[0];
+    for (u32 i = 1; i < thread_count; i++)
+        jobs.workers[i].thread = std::thread(run_worker, &jobs.workers[i]);
+}
+
+void stop_jobs()
+{
+    {
+        std::lock_guard<std::mutex> lock(jobs.mutex);
+        jobs.quit = true;
+    }
+    jobs.wake_up.notify_all();
+
+    for (u32 i = 1; i < jobs.worker_count; i++)
+        jobs.workers[i].thread.join();
+
+    delete[] jobs.workers;
+    jobs.workers = NULL;
+    jobs.worker_count = 0;
+    current_worker = NULL;
+}
+
+
+void run_job(Job_Function* function, void* user_data, Job_Counter* counter)
+{
+    if (counter)
+        counter->pending.fetch_add(1, std::memory_order_relaxed);
+
+    Job job = { function, user_data, counter };
+    if (!current_worker || !push(current_worker, job))
+    {
+        execute(job);
+        return;
+    }
+
+    jobs.pushed.fetch_add(1, std::memory_order_seq_cst);
+    if (jobs.sleeping.load(std::memory_order_seq_cst))
+    {
+        // Taking the lock makes sure a worker about to sleep either sees the job or gets the notify.
+        { std::lock_guard<std::mutex> lock(jobs.mutex); }
+        jobs.wake_up.notify_one();
+    }
+}
+
+void wait_for_jobs(Job_Counter* counter)
+{
+    while (!jobs_finished(counter))
+    {
+        Job job;
+        if (find_job(current_worker, &job))
+            execute(job);
+        else
+            std::this_thread::yield();
+    }
+}
+
+
+u32 get_job_worker_count()
+{
+    return jobs.worker_count;
+}
+
+u32 get_job_worker_index()
+{
+    return current_worker ? current_worker->index : U32_MAX;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+/*
+ *
+ * -- jobs
+ *
+ * A work stealing job system, for moving image decoding, redraws and exports off the UI thread.
+ * Each worker thread has its own deque of jobs. It runs the newest job it pushed, and when it runs
+ * out, it steals the oldest job of another worker. Jobs count down a Job_Counter when they finish,
+ * and waiting on a counter runs other jobs instead of blocking:
+ *
+ *     start_jobs(platform->system.logical_count);
+ *     ...
+ *     Job_Counter decoded = {};
+ *     for (umm i = 0; i < image_count; i++)
+ *         run_job(decode_image, &images[i], &decoded);
+ *     wait_for_jobs(&decoded);
+ *
+ * Jobs can start more jobs and wait on them, which is how dependencies are expressed. The thread that
+ * calls start_jobs becomes worker 0 and only runs jobs while it waits. Threads that aren't workers run
+ * their jobs right away. temp isn't thread safe, so jobs need their own memory, like a Region for each
+ * get_job_worker_index.
+ *
+ */
+
+#include "common.h"
+
+#include <atomic>
+
+
+typedef void Job_Function(void* user_data);
+
+struct Job_Counter
+{
+    std::atomic<u32> pending;  // Jobs started with this counter that haven't finished.
+};
+
+
+// thread_count includes the calling thread. 0 means the number of logical processors.
+void start_jobs(u32 thread_count);
+
+// Wait for the jobs first, the ones still queued are dropped.
+void stop_jobs();
+
+void run_job(Job_Function* function, void* user_data, Job_Counter* counter = NULL);
+
+// Runs queued jobs until the counter reaches zero.
+void wait_for_jobs(Job_Counter* counter);
+
+inline bool jobs_finished(Job_Counter* counter)
+{
+    return counter->pending.load(std::memory_order_acquire) == 0;
+}
+
+u32 get_job_worker_count();
+u32 get_job_worker_index();  // U32_MAX on threads that aren't workers.
@@ -0,0 +1,811 @@
+#include "json.h"
+#include "simd.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+//
+//
+// -- structural scanning
+//
+//
+
+
+// Returns the characters that are escaped by a backslash. A character is escaped
+// if it follows a run of backslashes of odd length. 'carry' is 1 if the first character
+// of the next block is escaped.
+static u64 find_escaped(u64 backslash, u64* carry)
+{
+    // A backslash that is itself escaped by the previous block doesn't start a run.
+    backslash &= ~*carry;
+    u64 follows_escape = (backslash << 1) | *carry;
+
+    // Adding the odd starting bits to the runs makes them carry past their ends,
+    // which flips the parity of everything they carry into.
+    const u64 even_bits = 0x5555555555555555;
+    u64 odd_sequence_starts = backslash & ~even_bits & ~follows_escape;
+    u64 sequences_starting_on_even_bits = odd_sequence_starts + backslash;
+    *carry = (sequences_starting_on_even_bits < backslash) ? 1 : 0;
+
+    u64 invert_mask = sequences_starting_on_even_bits << 1;
+    return (even_bits ^ invert_mask) & follows_escape;
+}
+
+
+// Classifies the next 64 bytes. Returns false at the end of input.
+static bool scan_next_block(Json_Reader* reader)
+{
+    String input = reader->input;
+    umm at = reader->next_block;
+    if (at >= input.length)
+        return false;
+
+    umm remaining = input.length - at;
+    Block64 block = (remaining >= 64) ? load_block64(input.data + at)
+                                      : load_partial_block64(input.data + at, remaining, ' ');
+
+    u64 escaped = find_escaped(equal_mask(&block, '\\'), &reader->escaped_carry);
+    u64 quotes = equal_mask(&block, '"') & ~escaped;
+
+    // Includes the opening quotes, but not the closing ones.
+    u64 in_string = prefix_xor(quotes) ^ reader->string_carry;
+    reader->string_carry = (u64)((i64) in_string >> 63);
+
+    u64 operators = equal_mask(&block, '{') | equal_mask(&block, '}') |
+                    equal_mask(&block, '[') | equal_mask(&block, ']') |
+                    equal_mask(&block, ':') | equal_mask(&block, ',');
+    u64 whitespace = equal_mask(&block, ' ')  | equal_mask(&block, '\t') |
+                     equal_mask(&block, '\n') | equal_mask(&block, '\r');
+
+    // Numbers, true, false and null. Only their first character is structural.
+    u64 scalar = ~(operators | whitespace | quotes | in_string);
+    u64 scalar_starts = scalar & ~((scalar << 1) | reader->scalar_carry);
+    reader->scalar_carry = scalar >> 63;
+
+    reader->structural = (operators & ~in_string) | (quotes & in_string) | scalar_starts;
+    reader->quotes = quotes;
+    reader->block_start = at;
+    reader->next_block = at + 64;
+    return true;
+}
+
+
+static bool next_structural(Json_Reader* reader, umm* at)
+{
+    while (!reader->structural)
+        if (!scan_next_block(reader))
+            return false;
+
+    *at = reader->block_start + count_trailing_zeros64(reader->structural);
+    reader->structural = clear_lowest_bit(reader->structural);
+    return true;
+}
+
+
+// The opening quote must be in the current block. Returns false if the string isn't terminated.
+static bool find_closing_quote(Json_Reader* reader, umm opening, umm* closing)
+{
+    u32 bit = (u32)(opening - reader->block_start);
+    reader->quotes &= (bit == 63) ? 0 : (~(u64) 0 << (bit + 1));
+
+    // Everything up to the closing quote is in the string, so the blocks
+    // skipped here have no structural characters before it.
+    while (!reader->quotes)
+        if (!scan_next_block(reader))
+            return false;
+
+    *closing = reader->block_start + count_trailing_zeros64(reader->quotes);
+    reader->quotes = clear_lowest_bit(reader->quotes);
+    return true;
+}
+
+
+static inline bool is_json_whitespace(u8 c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static inline bool ends_scalar(u8 c)
+{
+    return is_json_whitespace(c) || c == '"' ||
+           c == ',' || c == ':' || c == '[' || c == ']' || c == '{' || c == '}';
+}
+
+
+
+
+//
+//
+// -- pull reading
+//
+//
+
+
+enum: u8
+{
+    EXPECT_VALUE,
+    EXPECT_VALUE_OR_ARRAY_END,
+    EXPECT_KEY,
+    EXPECT_KEY_OR_OBJECT_END,
+    EXPECT_COLON,
+    EXPECT_COMMA_OR_END,
+    EXPECT_NOTHING,
+};
+
+
+void set_input(Json_Reader* reader, String input)
+{
+    ZeroStruct(reader);
+    reader->input = input;
+}
+
+
+static bool fail(Json_Reader* reader, umm at)
+{
+    reader->failed = true;
+    reader->error_offset = at;
+    return false;
+}
+
+static bool is_in_object(Json_Reader* reader)
+{
+    u32 index = reader->depth - 1;
+    return (reader->is_object[index / 64] >> (index % 64)) & 1;
+}
+
+static void after_value(Json_Reader* reader)
+{
+    reader->expect = reader->depth ? EXPECT_COMMA_OR_END : EXPECT_NOTHING;
+}
+
+
+static bool open_container(Json_Reader* reader, Json_Token* token, bool is_object, umm at)
+{
+    if (reader->depth == JSON_MAX_DEPTH)
+        return fail(reader, at);
+
+    u32 index = reader->depth++;
+    u64 bit = (u64) 1 << (index % 64);
+    if (is_object) reader->is_object[index / 64] |= bit;
+    else           reader->is_object[index / 64] &= ~bit;
+
+    token->kind = is_object ? Json_Token::OBJECT_BEGIN : Json_Token::ARRAY_BEGIN;
+    reader->expect = is_object ? EXPECT_KEY_OR_OBJECT_END : EXPECT_VALUE_OR_ARRAY_END;
+    return true;
+}
+
+static bool close_container(Json_Reader* reader, Json_Token* token, u8 c, umm at)
+{
+    bool is_object = c == '}';
+    if (!reader->depth || is_in_object(reader) != is_object)
+        return fail(reader, at);
+
+    reader->depth--;
+    token->kind = is_object ? Json_Token::OBJECT_END : Json_Token::ARRAY_END;
+    after_value(reader);
+    return true;
+}
+
+static bool read_string(Json_Reader* reader, Json_Token* token, umm opening)
+{
+    umm closing;
+    if (!find_closing_quote(reader, opening, &closing))
+        return fail(reader, opening);
+
+    token->text.data = reader->input.data + opening + 1;
+    token->text.length = closing - opening - 1;
+    token->has_escapes = memchr(token->text.data, '\\', token->text.length) != NULL;
+    return true;
+}
+
+static inline bool is_digit(u8 c)
+{
+    return (u8)(c - '0') < 10;
+}
+
+// -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+static bool is_valid_number(String text)
+{
+    u8* at = text.data;
+    u8* end = text.data + text.length;
+
+    if (at < end && *at == '-') at++;
+    if (at == end || !is_digit(*at)) return false;
+    if (*(at++) != '0')
+        while (at < end && is_digit(*at)) at++;
+
+    if (at < end && *at == '.')
+    {
+        at++;
+        if (at == end || !is_digit(*at)) return false;
+        while (at < end && is_digit(*at)) at++;
+    }
+
+    if (at < end && (*at == 'e' || *at == 'E'))
+    {
+        at++;
+        if (at < end && (*at == '+' || *at == '-')) at++;
+        if (at == end || !is_digit(*at)) return false;
+        while (at < end && is_digit(*at)) at++;
+    }
+
+    return at == end;
+}
+
+static bool read_value(Json_Reader* reader, Json_Token* token, u8 c, umm at)
+{
+    if (c == '{') return open_container(reader, token, true, at);
+    if (c == '[') return open_container(reader, token, false, at);
+
+    if (c == '"')
+    {
+        if (!read_string(reader, token, at))
+            return false;
+
+        token->kind = Json_Token::STRING;
+        after_value(reader);
+        return true;
+    }
+
+    // The scalar ends at the next structural character, less the whitespace before it.
+    String input = reader->input;
+    umm end;
+    if (reader->structural)
+    {
+        end = reader->block_start + count_trailing_zeros64(reader->structural);
+        while (end > at && is_json_whitespace(input.data[end - 1]))
+            end--;
+    }
+    else
+    {
+        end = at;
+        while (end < input.length && !ends_scalar(input.data[end]))
+            end++;
+    }
+
+    token->text.data = input.data + at;
+    token->text.length = end - at;
+
+    if (is_valid_number(token->text))    token->kind = Json_Token::NUMBER;
+    else if (token->text == "true"_s)    token->kind = Json_Token::TRUE_VALUE;
+    else if (token->text == "false"_s)   token->kind = Json_Token::FALSE_VALUE;
+    else if (token->text == "null"_s)    token->kind = Json_Token::NULL_VALUE;
+    else return fail(reader, at);
+
+    after_value(reader);
+    return true;
+}
+
+
+bool read_token(Json_Reader* reader, Json_Token* token)
+{
+    token->kind = Json_Token::END;
+    token->has_escapes = false;
+    token->text = {};
+
+    if (reader->failed)
+        return false;
+
+    while (true)
+    {
+        umm at;
+        if (!next_structural(reader, &at))
+        {
+            if (reader->expect != EXPECT_NOTHING)
+                return fail(reader, reader->input.length);
+            return false;
+        }
+
+        u8 c = reader->input.data[at];
+        switch (reader->expect)
+        {
+        case EXPECT_COLON:
+        {
+            if (c != ':')
+                return fail(reader, at);
+            reader->expect = EXPECT_VALUE;
+        } break;
+
+        case EXPECT_COMMA_OR_END:
+        {
+            if (c == '}' || c == ']')
+                return close_container(reader, token, c, at);
+            if (c != ',')
+                return fail(reader, at);
+            reader->expect = is_in_object(reader) ? EXPECT_KEY : EXPECT_VALUE;
+        } break;
+
+        case EXPECT_KEY_OR_OBJECT_END:
+        case EXPECT_KEY:
+        {
+            if (c == '}' && reader->expect == EXPECT_KEY_OR_OBJECT_END)
+                return close_container(reader, token, c, at);
+            if (c != '"' || !read_string(reader, token, at))
+                return fail(reader, at);
+
+            token->kind = Json_Token::KEY;
+            reader->expect = EXPECT_COLON;
+            return true;
+        } break;
+
+        case EXPECT_VALUE_OR_ARRAY_END:
+        case EXPECT_VALUE:
+        {
+            if (c == ']' && reader->expect == EXPECT_VALUE_OR_ARRAY_END)
+                return close_container(reader, token, c, at);
+            if (c == '}' || c == ']' || c == ',' || c == ':')
+                return fail(reader, at);
+            return read_value(reader, token, c, at);
+        } break;
+
+        default:
+            return fail(reader, at);
+        }
+    }
+}
+
+
+bool skip_value(Json_Reader* reader)
+{
+    Json_Token token;
+    u32 depth = 0;
+    do
+    {
+        if (!read_token(reader, &token))
+            return false;
+
+        if (token.kind == Json_Token::OBJECT_BEGIN || token.kind == Json_Token::ARRAY_BEGIN)
+            depth++;
+        else if (token.kind == Json_Token::OBJECT_END || token.kind == Json_Token::ARRAY_END)
+            depth--;
+    }
+    while (depth);
+
+    return true;
+}
+
+
+static bool parse_hex4(u8* digits, u32* result)
+{
+    u32 value = 0;
+    for (u32 i = 0; i < 4; i++)
+    {
+        u8 c = digits[i];
+        u32 digit;
+        if      (c >= '0' && c <= '9') digit = c - '0';
+        else if (c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') digit = c - 'A' + 10;
+        else return false;
+        value = (value << 4) | digit;
+    }
+
+    *result = value;
+    return true;
+}
+
+static u8* write_utf8(u8* write, u32 code_point)
+{
+    if (code_point < 0x80)
+    {
+        *(write++) = (u8) code_point;
+    }
+    else if (code_point < 0x800)
+    {
+        *(write++) = (u8)(0xC0 | (code_point >> 6));
+        *(write++) = (u8)(0x80 | (code_point & 0x3F));
+    }
+    else if (code_point < 0x10000)
+    {
+        *(write++) = (u8)(0xE0 | (code_point >> 12));
+        *(write++) = (u8)(0x80 | ((code_point >> 6) & 0x3F));
+        *(write++) = (u8)(0x80 | (code_point & 0x3F));
+    }
+    else
+    {
+        *(write++) = (u8)(0xF0 | (code_point >> 18));
+        *(write++) = (u8)(0x80 | ((code_point >> 12) & 0x3F));
+        *(write++) = (u8)(0x80 | ((code_point >> 6) & 0x3F));
+        *(write++) = (u8)(0x80 | (code_point & 0x3F));
+    }
+    return write;
+}
+
+
+String unescape_json(String text, Region* memory)
+{
+    u8* backslash = (u8*) memchr(text.data, '\\', text.length);
+    if (!backslash)
+        return text;
+
+    // Escapes never decode to more bytes than they are written with.
+    String result;
+    result.data = LK_RegionArray(memory, u8, text.length);
+
+    umm prefix_length = backslash - text.data;
+    copy(result.data, text.data, prefix_length);
+
+    u8* write = result.data + prefix_length;
+    u8* read = backslash;
+    u8* end = text.data + text.length;
+    while (read < end)
+    {
+        if (*read != '\\' || read + 1 == end)
+        {
+            *(write++) = *(read++);
+            continue;
+        }
+
+        u8 c = read[1];
+        read += 2;
+        switch (c)
+        {
+        case 'b': *(write++) = '\b'; break;
+        case 'f': *(write++) = '\f'; break;
+        case 'n': *(write++) = '\n'; break;
+        case 'r': *(write++) = '\r'; break;
+        case 't': *(write++) = '\t'; break;
+        case 'u':
+        {
+            u32 code_point;
+            if (end - read < 4 || !parse_hex4(read, &code_point))
+            {
+                // Malformed, keep it as it is.
+                *(write++) = '\\';
+                *(write++) = 'u';
+                break;
+            }
+            read += 4;
+
+            // Surrogate pair.
+            u32 low;
+            if (code_point >= 0xD800 && code_point < 0xDC00 && end - read >= 6 &&
+                read[0] == '\\' && read[1] == 'u' && parse_hex4(read + 2, &low) && low >= 0xDC00 && low < 0xE000)
+            {
+                code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+                read += 6;
+            }
+
+            write = write_utf8(write, code_point);
+        } break;
+        default: *(write++) = c; break;  // \" \\ \/
+        }
+    }
+
+    result.length = write - result.data;
+    return result;
+}
+
+
+
+
+//
+//
+// -- DOM reading
+//
+//
+
+
+static_assert(sizeof(Json_Value) == 16, "Json_Value is expected to be 16 bytes");
+static_assert(sizeof(Json_Member) == 2 * sizeof(Json_Value), "members are copied as pairs of values");
+
+
+bool parse_json(String text, Json_Value* result, Region* memory)
+{
+    Json_Reader reader;
+    set_input(&reader, text);
+
+    // Values of the containers that are still open, and where each container's values begin.
+    Json_Value* stack = NULL;
+    umm stack_count = 0;
+    umm stack_capacity = 0;
+    Defer(free(stack));
+
+    umm starts[JSON_MAX_DEPTH];
+    u32 depth = 0;
+
+    Json_Token token;
+    while (read_token(&reader, &token))
+    {
+        Json_Value value = {};
+        switch (token.kind)
+        {
+        case Json_Token::OBJECT_BEGIN:
+        case Json_Token::ARRAY_BEGIN:
+        {
+            starts[depth++] = stack_count;
+            continue;
+        } break;
+
+        case Json_Token::OBJECT_END:
+        case Json_Token::ARRAY_END:
+        {
+            umm start = starts[--depth];
+            umm count = stack_count - start;
+            stack_count = start;
+
+            bool is_object = token.kind == Json_Token::OBJECT_END;
+            value.kind = is_object ? Json_Value::OBJECT : Json_Value::ARRAY;
+            value.count = (u32)(is_object ? count / 2 : count);
+            if (count)
+            {
+                value.elements = LK_RegionArray(memory, Json_Value, count);
+                copy(value.elements, stack + start, count * sizeof(Json_Value));
+            }
+        } break;
+
+        case Json_Token::KEY:
+        case Json_Token::STRING:
+        case Json_Token::NUMBER:
+        {
+            DebugAssert(token.text.length <= U32_MAX);
+            value.kind = (token.kind == Json_Token::NUMBER) ? Json_Value::NUMBER : Json_Value::STRING;
+            value.has_escapes = token.has_escapes;
+            value.count = (u32) token.text.length;
+            value.text = token.text.data;
+        } break;
+
+        case Json_Token::TRUE_VALUE:
+        case Json_Token::FALSE_VALUE:
+        {
+            value.kind = Json_Value::BOOL;
+            value.boolean = token.kind == Json_Token::TRUE_VALUE;
+        } break;
+
+        default: break;  // NULL_VALUE
+        }
+
+        if (stack_count == stack_capacity)
+        {
+            stack_capacity = stack_capacity ? stack_capacity + (stack_capacity >> 1) : 256;
+            stack = (Json_Value*) realloc(stack, stack_capacity * sizeof(Json_Value));
+        }
+        stack[stack_count++] = value;
+    }
+
+    if (reader.failed)
+        return false;
+
+    DebugAssert(stack_count == 1);
+    *result = stack[0];
+    return true;
+}
+
+
+Json_Value* get_member(Json_Value* object, String key)
+{
+    if (object->kind != Json_Value::OBJECT)
+        return NULL;
+
+    for (u32 i = 0; i < object->count; i++)
+    {
+        Json_Member* member = &object->members[i];
+        if (get_raw_text(&member->key) == key)
+            return &member->value;
+    }
+
+    return NULL;
+}
+
+
+String get_string(Json_Value* value, Region* memory)
+{
+    if (value->kind != Json_Value::STRING)
+        return {};
+
+    String text = get_raw_text(value);
+    if (!value->has_escapes)
+        return text;
+    return unescape_json(text, memory);
+}
+
+bool get_f64(Json_Value* value, f64* result)
+{
+    return value->kind == Json_Value::NUMBER && parse_f64(get_raw_text(value), result);
+}
+
+bool get_i64(Json_Value* value, i64* result)
+{
+    return value->kind == Json_Value::NUMBER && parse_i64(get_raw_text(value), result);
+}
+
+bool get_u64(Json_Value* value, u64* result)
+{
+    return value->kind == Json_Value::NUMBER && parse_u64(get_raw_text(value), result);
+}
+
+
+
+
+//
+//
+// -- writing
+//
+//
+
+
+static void write_new_line(Json_Writer* writer)
+{
+    append(writer->builder, "\n"_s);
+    for (u32 i = 0; i < writer->depth; i++)
+        append(writer->builder, "    "_s);
+}
+
+// Writes what has to come before a value: a comma and a new line, unless the value follows a key.
+static void begin_value(Json_Writer* writer)
+{
+    if (writer->after_key)
+    {
+        writer->after_key = false;
+        return;
+    }
+
+    if (writer->need_comma)
+        append(writer->builder, ","_s);
+    if (writer->pretty && writer->depth)
+        write_new_line(writer);
+    writer->need_comma = true;
+}
+
+static void begin_container(Json_Writer* writer, const char* bracket)
+{
+    begin_value(writer);
+    append(writer->builder, bracket);
+    writer->depth++;
+    writer->need_comma = false;
+}
+
+static void end_container(Json_Writer* writer, const char* bracket)
+{
+    DebugAssert(writer->depth && !writer->after_key);
+    writer->depth--;
+    if (writer->pretty && writer->need_comma)
+        write_new_line(writer);
+    append(writer->builder, bracket);
+    writer->need_comma = true;
+}
+
+
+void begin_object(Json_Writer* writer) { begin_container(writer, "{"); }
+void end_object  (Json_Writer* writer) { end_container  (writer, "}"); }
+void begin_array (Json_Writer* writer) { begin_container(writer, "["); }
+void end_array   (Json_Writer* writer) { end_container  (writer, "]"); }
+
+
+static void append_escaped(String_Builder* builder, String string)
+{
+    append(builder, "\""_s);
+
+    umm run_start = 0;
+    for (umm i = 0; i < string.length; i++)
+    {
+        u8 c = string.data[i];
+        if (c >= 0x20 && c != '"' && c != '\\')
+            continue;
+
+        append(builder, string.data + run_start, i - run_start);
+        run_start = i + 1;
+
+        switch (c)
+        {
+        case '"':  append(builder, "\\\""_s); break;
+        case '\\': append(builder, "\\\\"_s); break;
+        case '\b': append(builder, "\\b"_s);  break;
+        case '\f': append(builder, "\\f"_s);  break;
+        case '\n': append(builder, "\\n"_s);  break;
+        case '\r': append(builder, "\\r"_s);  break;
+        case '\t': append(builder, "\\t"_s);  break;
+        default:
+        {
+            const char* hex = "0123456789abcdef";
+            u8 escape[6] = { '\\', 'u', '0', '0', (u8) hex[c >> 4], (u8) hex[c & 15] };
+            append(builder, escape, 6);
+        } break;
+        }
+    }
+
+    append(builder, string.data + run_start, string.length - run_start);
+    append(builder, "\""_s);
+}
+
+
+void write_key(Json_Writer* writer, String key)
+{
+    DebugAssert(!writer->after_key);
+    begin_value(writer);
+    append_escaped(writer->builder, key);
+    append(writer->builder, writer->pretty ? ": "_s : ":"_s);
+    writer->after_key = true;
+}
+
+void write_string(Json_Writer* writer, String value)
+{
+    begin_value(writer);
+    append_escaped(writer->builder, value);
+}
+
+void write_f64(Json_Writer* writer, f64 value)
+{
+    begin_value(writer);
+
+    u64 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    if (((bits >> 52) & 0x7FF) == 0x7FF)
+        append(writer->builder, "null"_s);
+    else
+        append_f64(writer->builder, value);
+}
+
+void write_i64(Json_Writer* writer, i64 value)
+{
+    begin_value(writer);
+    append_i64(writer->builder, value);
+}
+
+void write_u64(Json_Writer* writer, u64 value)
+{
+    begin_value(writer);
+    append_u64(writer->builder, value);
+}
+
+void write_bool(Json_Writer* writer, bool value)
+{
+    begin_value(writer);
+    append(writer->builder, value ? "true"_s : "false"_s);
+}
+
+void write_null(Json_Writer* writer)
+{
+    begin_value(writer);
+    append(writer->builder, "null"_s);
+}
+
+
+void write_value(Json_Writer* writer, Json_Value* value)
+{
+    switch (value->kind)
+    {
+    case Json_Value::NULL_VALUE: write_null(writer); break;
+    case Json_Value::BOOL:       write_bool(writer, value->boolean); break;
+
+    case Json_Value::NUMBER:
+    {
+        begin_value(writer);
+        append(writer->builder, get_raw_text(value));
+    } break;
+
+    case Json_Value::STRING:
+    {
+        // The raw text is already escaped.
+        begin_value(writer);
+        append(writer->builder, "\""_s);
+        append(writer->builder, get_raw_text(value));
+        append(writer->builder, "\""_s);
+    } break;
+
+    case Json_Value::ARRAY:
+    {
+        begin_array(writer);
+        for (u32 i = 0; i < value->count; i++)
+            write_value(writer, &value->elements[i]);
+        end_array(writer);
+    } break;
+
+    case Json_Value::OBJECT:
+    {
+        begin_object(writer);
+        for (u32 i = 0; i < value->count; i++)
+        {
+            Json_Member* member = &value->members[i];
+            begin_value(writer);
+            append(writer->builder, "\""_s);
+            append(writer->builder, get_raw_text(&member->key));
+            append(writer->builder, writer->pretty ? "\": "_s : "\":"_s);
+            writer->after_key = true;
+
+            write_value(writer, &member->value);
+        }
+        end_object(writer);
+    } break;
+    }
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+/*
+ *
+ * -- JSON reading and writing
+ *
+ * The reader finds structural characters 64 bytes at a time and returns strings and numbers as
+ * views into the input. String escapes are only decoded when asked for, with get_string or unescape_json.
+ * The structure and numbers are validated, the contents of strings are not.
+ *
+ * There are two ways of reading:
+ *  - pull: read_token returns one token at a time and uses no memory beyond the Json_Reader,
+ *  - DOM: parse_json builds a tree of Json_Values in a region. Values are 16 bytes each.
+ *
+ */
+
+#include "common.h"
+
+
+constexpr u32 JSON_MAX_DEPTH = 1024;
+
+
+//
+// Pull reading.
+//
+
+
+struct Json_Token
+{
+    enum Kind: u8
+    {
+        END,  // End of input, or an error.
+        OBJECT_BEGIN,
+        OBJECT_END,
+        ARRAY_BEGIN,
+        ARRAY_END,
+        KEY,
+        STRING,
+        NUMBER,
+        TRUE_VALUE,
+        FALSE_VALUE,
+        NULL_VALUE,
+    };
+
+    Kind kind;
+    bool has_escapes;  // KEY and STRING: the text contains escape sequences.
+    String text;       // KEY and STRING: without the quotes. NUMBER: the number as written.
+};
+
+struct Json_Reader
+{
+    bool failed;
+    umm error_offset;
+
+    // Internal scanning state.
+    String input;
+    umm block_start;
+    umm next_block;
+    u64 structural;  // Unvisited structural characters in the current block.
+    u64 quotes;      // Unvisited unescaped quotes in the current block.
+    u64 escaped_carry;
+    u64 string_carry;
+    u64 scalar_carry;
+
+    // Internal grammar state.
+    u8  expect;
+    u32 depth;
+    u64 is_object[JSON_MAX_DEPTH / 64];  // One bit per open container.
+};
+
+
+void set_input(Json_Reader* reader, String input);
+
+// Returns false at the end of input, or on error (check reader->failed).
+bool read_token(Json_Reader* reader, Json_Token* token);
+
+// Skips the next value, including everything inside it if it's an object or array.
+bool skip_value(Json_Reader* reader);
+
+// Decodes escape sequences. Doesn't copy when there is nothing to decode.
+String unescape_json(String text, Region* memory = temp);
+
+
+//
+// DOM reading.
+//
+
+
+struct Json_Member;
+
+struct Json_Value
+{
+    enum Kind: u8
+    {
+        NULL_VALUE,
+        BOOL,
+        NUMBER,
+        STRING,
+        ARRAY,
+        OBJECT,
+    };
+
+    Kind kind;
+    bool has_escapes;  // STRING
+    bool boolean;      // BOOL
+    u32 count;         // Text length for NUMBER and STRING, element or member count for ARRAY and OBJECT.
+    union
+    {
+        u8* text;
+        Json_Value* elements;
+        Json_Member* members;
+    };
+};
+
+struct Json_Member
+{
+    Json_Value key;  // Always a STRING.
+    Json_Value value;
+};
+
+
+// The values point into text, which has to outlive them.
+bool parse_json(String text, Json_Value* result, Region* memory = temp);
+
+// Keys are compared as written, without decoding escapes. Returns NULL if there is no such member.
+Json_Value* get_member(Json_Value* object, String key);
+
+String get_string(Json_Value* value, Region* memory = temp);  // Decodes escapes. Empty if not a STRING.
+bool get_f64(Json_Value* value, f64* result);
+bool get_i64(Json_Value* value, i64* result);
+bool get_u64(Json_Value* value, u64* result);
+
+
+inline Json_Value* get_element(Json_Value* array, umm index)
+{
+    DebugAssert(array->kind == Json_Value::ARRAY && index < array->count);
+    return &array->elements[index];
+}
+
+inline String get_raw_text(Json_Value* value)
+{
+    DebugAssert(value->kind == Json_Value::STRING || value->kind == Json_Value::NUMBER);
+
+    String result;
+    result.length = value->count;
+    result.data = value->text;
+    return result;
+}
+
+
+//
+// Writing.
+// Calls have to follow JSON structure, keys are only written inside objects and must precede values.
+//
+
+
+struct Json_Writer
+{
+    String_Builder* builder;
+    bool pretty;  // Newlines and indentation.
+
+    // Internal.
+    u32 depth;
+    bool need_comma;
+    bool after_key;
+};
+
+
+void begin_object(Json_Writer* writer);
+void end_object  (Json_Writer* writer);
+void begin_array (Json_Writer* writer);
+void end_array   (Json_Writer* writer);
+
+void write_key   (Json_Writer* writer, String key);
+void write_string(Json_Writer* writer, String value);
+void write_f64   (Json_Writer* writer, f64 value);  // Shortest round trip form. Non-finite values are written as null.
+void write_i64   (Json_Writer* writer, i64 value);
+void write_u64   (Json_Writer* writer, u64 value);
+void write_bool  (Json_Writer* writer, bool value);
+void write_null  (Json_Writer* writer);
+
+// Writes a value from a DOM, with all of its contents.
+void write_value (Json_Writer* writer, Json_Value* value);
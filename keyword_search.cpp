@@ -0,0 +1,259 @@
+#include "keyword_search.h"
+#include "simd.h"
+
+
+static inline u8 fold_case(u8 byte, bool ignore_case)
+{
+    if (ignore_case && byte >= 'A' && byte <= 'Z')
+        return byte - 'A' + 'a';
+    return byte;
+}
+
+
+bool compile_keyword_search(Keyword_Search* search, String* keywords, umm keyword_count, Region* memory, bool ignore_case)
+{
+    ZeroStruct(search);
+
+    Region scratch = {};
+    Defer(lk_region_free(&scratch));
+
+    // Every byte that appears in a keyword gets a class of its own, shared with its other case when ignoring case.
+    u32 classes[256] = {};
+    u32 class_count = 1;
+    umm max_states = 1;
+    for (umm i = 0; i < keyword_count; i++)
+    {
+        if (!keywords[i].length)
+            return false;
+
+        max_states += keywords[i].length;
+        for (umm j = 0; j < keywords[i].length; j++)
+        {
+            u8 byte = fold_case(keywords[i].data[j], ignore_case);
+            if (!classes[byte])
+                classes[byte] = class_count++;
+        }
+    }
+
+    // If every byte is used, nothing is left for class 0.
+    if (class_count > 256)
+    {
+        for (u32 c = 0; c < 256; c++)
+            classes[c]--;
+        class_count = 256;
+    }
+
+    if (ignore_case)
+        for (u32 c = 'A'; c <= 'Z'; c++)
+            classes[c] = classes[c - 'A' + 'a'];
+
+    if (max_states * class_count >= U32_MAX)
+        return false;
+
+    // Build the trie. Missing children are 0, which is also what they become in the finished
+    // automaton when the start state has no child for a byte.
+    u32* trie = LK_RegionArray(&scratch, u32, max_states * class_count);
+    memset(trie, 0, max_states * class_count * sizeof(u32));
+
+    u32* matches = LK_RegionArray(&scratch, u32, max_states);
+    memset(matches, 0xFF, max_states * sizeof(u32));
+
+    u32 state_count = 1;
+    for (umm i = 0; i < keyword_count; i++)
+    {
+        u32 state = 0;
+        for (umm j = 0; j < keywords[i].length; j++)
+        {
+            u32* next = &trie[state * class_count + classes[keywords[i].data[j]]];
+            if (!*next)
+                *next = state_count++;
+            state = *next;
+        }
+
+        if (matches[state] == U32_MAX)
+            matches[state] = (u32) i;
+    }
+
+    // Walk the trie breadth first, filling in the missing transitions from the failure state,
+    // which is shallower and so already complete.
+    u32* failures = LK_RegionArray(&scratch, u32, state_count);
+    u32* next_outputs = LK_RegionArray(&scratch, u32, state_count);
+    u32* queue = LK_RegionArray(&scratch, u32, state_count);
+    next_outputs[0] = 0;
+
+    u32 queue_start = 0;
+    u32 queue_end = 0;
+    for (u32 c = 0; c < class_count; c++)
+    {
+        u32 child = trie[c];
+        if (child)
+        {
+            failures[child] = 0;
+            queue[queue_end++] = child;
+        }
+    }
+
+    while (queue_start < queue_end)
+    {
+        u32 state = queue[queue_start++];
+        u32 failure = failures[state];
+        next_outputs[state] = (matches[failure] != U32_MAX) ? failure : next_outputs[failure];
+
+        u32* row = trie + (umm) state * class_count;
+        u32* failure_row = trie + (umm) failure * class_count;
+        for (u32 c = 0; c < class_count; c++)
+        {
+            if (row[c])
+            {
+                failures[row[c]] = failure_row[c];
+                queue[queue_end++] = row[c];
+            }
+            else
+            {
+                row[c] = failure_row[c];
+            }
+        }
+    }
+
+    // Renumber the states so the ones with matches come last. Then the scanning loop
+    // needs a single compare per byte to know if it found something.
+    u32* renumbered = LK_RegionArray(&scratch, u32, state_count);
+    u32 plain_count = 0;
+    for (u32 state = 0; state < state_count; state++)
+        if (matches[state] == U32_MAX && !next_outputs[state])
+            renumbered[state] = plain_count++;
+
+    u32 next_number = plain_count;
+    for (u32 state = 0; state < state_count; state++)
+        if (matches[state] != U32_MAX || next_outputs[state])
+            renumbered[state] = next_number++;
+
+    search->state_count = state_count;
+    search->class_count = class_count;
+    for (u32 c = 0; c < 256; c++)
+        search->classes[c] = (u8) classes[c];
+    search->first_output_state = plain_count * class_count;
+
+    search->transitions = LK_RegionArray(memory, u32, (umm) state_count * class_count);
+    search->matches = LK_RegionArray(memory, u32, state_count);
+    search->next_outputs = LK_RegionArray(memory, u32, state_count);
+    for (u32 state = 0; state < state_count; state++)
+    {
+        u32 number = renumbered[state];
+        u32* from = trie + (umm) state * class_count;
+        u32* to = search->transitions + (umm) number * class_count;
+        for (u32 c = 0; c < class_count; c++)
+            to[c] = renumbered[from[c]] * class_count;
+
+        search->matches[number] = matches[state];
+        search->next_outputs[number] = renumbered[next_outputs[state]];
+    }
+
+    search->keyword_count = (u32) keyword_count;
+    search->keyword_lengths = LK_RegionArray(memory, u32, keyword_count);
+    for (umm i = 0; i < keyword_count; i++)
+        search->keyword_lengths[i] = (u32) keywords[i].length;
+
+    // The bytes that leave the start state. If there are only a few, the scanner looks for them with SIMD.
+    u32 first_byte_count = 0;
+    for (u32 c = 0; c < 256; c++)
+    {
+        if (!trie[classes[c]])
+            continue;
+
+        if (first_byte_count == ArrayCount(search->first_bytes))
+        {
+            first_byte_count = 0;
+            break;
+        }
+        search->first_bytes[first_byte_count++] = (u8) c;
+    }
+    search->first_byte_count = first_byte_count;
+
+    return true;
+}
+
+
+Keyword_Scanner make_keyword_scanner(Keyword_Search* search, String text)
+{
+    Keyword_Scanner scanner = {};
+    scanner.search = search;
+    scanner.text = text;
+    return scanner;
+}
+
+
+// Skips ahead to the next byte that can start a keyword. The tail that doesn't fill a block is left
+// to the automaton.
+static umm skip_to_first_byte(Keyword_Search* search, String text, umm position)
+{
+    while (position + 64 <= text.length)
+    {
+        Block64 block = load_block64(text.data + position);
+
+        u64 mask = 0;
+        for (u32 i = 0; i < search->first_byte_count; i++)
+            mask |= equal_mask(&block, search->first_bytes[i]);
+
+        if (mask)
+            return position + count_trailing_zeros64(mask);
+        position += 64;
+    }
+    return position;
+}
+
+
+bool find_next(Keyword_Scanner* scanner, Keyword_Match* match)
+{
+    Keyword_Search* search = scanner->search;
+
+    u32 output = scanner->pending_output;
+    if (!output)
+    {
+        u32* transitions = search->transitions;
+        u8* classes = search->classes;
+        u8* text = scanner->text.data;
+        umm length = scanner->text.length;
+        umm position = scanner->position;
+        u32 state = scanner->state;
+        while (true)
+        {
+            if (!state && search->first_byte_count)
+                position = skip_to_first_byte(search, scanner->text, position);
+
+            if (position >= length)
+            {
+                scanner->position = position;
+                scanner->state = state;
+                return false;
+            }
+
+            state = transitions[state + classes[text[position++]]];
+            if (state >= search->first_output_state)
+                break;
+        }
+
+        scanner->position = position;
+        scanner->state = state;
+
+        // The state may only have matches through its suffixes.
+        output = state / search->class_count;
+        if (search->matches[output] == U32_MAX)
+            output = search->next_outputs[output];
+    }
+
+    u32 keyword = search->matches[output];
+    match->keyword = keyword;
+    match->length = search->keyword_lengths[keyword];
+    match->offset = scanner->position - match->length;
+    scanner->pending_output = search->next_outputs[output];
+    return true;
+}
+
+
+bool contains_keyword(Keyword_Search* search, String text)
+{
+    Keyword_Scanner scanner = make_keyword_scanner(search, text);
+    Keyword_Match match;
+    return find_next(&scanner, &match);
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+/*
+ *
+ * -- finding many keywords in one pass
+ *
+ * A set of keywords is compiled once into an Aho-Corasick automaton, after which a text is scanned
+ * one table lookup per byte, however many keywords there are. All occurrences are reported,
+ * including ones that overlap:
+ *
+ *     Keyword_Search search;
+ *     String keywords[] = { "error"_s, "warning"_s, "NaN"_s };
+ *     compile_keyword_search(&search, keywords, 3, &memory);
+ *     ...
+ *     find_keywords(&search, log, [&] (Keyword_Match match)
+ *     {
+ *         counts[match.keyword]++;
+ *     });
+ *
+ * or, when the loop needs to stop early or keep its own state:
+ *
+ *     Keyword_Scanner scanner = make_keyword_scanner(&search, log);
+ *     Keyword_Match match;
+ *     while (find_next(&scanner, &match))
+ *         ...
+ *
+ * Matches come in order of where they end. Matches that end at the same byte come longest first.
+ * When only a few different bytes start keywords, the text between them is skipped with SIMD
+ * compares instead of going through the automaton byte by byte.
+ * Matching is on bytes, ignore_case only folds ASCII letters.
+ *
+ */
+
+#include "common.h"
+
+
+struct Keyword_Search
+{
+    u32 state_count;
+    u32 class_count;
+    u8 classes[256];           // Bytes that don't appear in any keyword share class 0.
+    u32* transitions;          // state_count * class_count, holding offsets of rows. Row 0 is the start state.
+    u32 first_output_state;    // Rows from here on have matches, the ones before don't.
+
+    u32* matches;              // Per state, the keyword that ends there, or U32_MAX.
+    u32* next_outputs;         // Per state, the next shorter suffix state that has a match, or 0.
+
+    u32 keyword_count;
+    u32* keyword_lengths;
+
+    u32 first_byte_count;      // Zero when keywords start with too many different bytes to skip ahead.
+    u8 first_bytes[8];
+};
+
+struct Keyword_Match
+{
+    umm offset;    // Where in the text the keyword starts.
+    umm length;
+    u32 keyword;   // Index in the array given to compile_keyword_search. Duplicate keywords report the first one.
+};
+
+struct Keyword_Scanner
+{
+    Keyword_Search* search;
+    String text;
+    umm position;
+    u32 state;
+    u32 pending_output;  // A state whose matches haven't been reported yet, or 0.
+};
+
+
+// Returns false if a keyword is empty, or if there are too many keywords to fit the automaton in 32-bit offsets.
+bool compile_keyword_search(Keyword_Search* search, String* keywords, umm keyword_count,
+                            Region* memory = temp, bool ignore_case = false);
+
+Keyword_Scanner make_keyword_scanner(Keyword_Search* search, String text);
+
+// Returns false when there are no more matches.
+bool find_next(Keyword_Scanner* scanner, Keyword_Match* match);
+
+// Stops at the first match, without looking for the others.
+bool contains_keyword(Keyword_Search* search, String text);
+
+
+// Calls 'callback' with every Keyword_Match.
+template <typename F>
+void find_keywords(Keyword_Search* search, String text, F callback)
+{
+    Keyword_Scanner scanner = make_keyword_scanner(search, text);
+    Keyword_Match match;
+    while (find_next(&scanner, &match))
+        callback(match);
+}
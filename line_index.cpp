@@ -0,0 +1,164 @@
+#include "line_index.h"
+#include "simd.h"
+
+
+static inline bool is_line_ending(u8 character)
+{
+    return character == '\n' || character == '\r';
+}
+
+static inline u64 line_ending_mask(Block64* block)
+{
+    return equal_mask(block, '\n') | equal_mask(block, '\r');
+}
+
+
+// An upper bound on the number of line endings, two character endings count twice.
+static umm count_line_ending_characters(String text)
+{
+    umm count = 0;
+    umm at = 0;
+    for (; at + 64 <= text.length; at += 64)
+    {
+        Block64 block = load_block64(text.data + at);
+        count += count_set_bits64(line_ending_mask(&block));
+    }
+
+    for (; at < text.length; at++)
+        if (is_line_ending(text.data[at]))
+            count++;
+
+    return count;
+}
+
+
+Line_Index build_line_index(String text, Region* memory)
+{
+    Line_Index result = {};
+    if (!text)
+        return result;
+
+    umm capacity = count_line_ending_characters(text) + 1;
+    umm* starts = LK_RegionArray(memory, umm, capacity);
+    umm count = 0;
+    starts[count++] = 0;
+
+    // Line ending characters before this offset belong to the previous line ending,
+    // this is how the second half of "\r\n" and "\n\r" is skipped.
+    umm previous_end = 0;
+
+    for (umm block_start = 0; block_start < text.length; block_start += 64)
+    {
+        umm remaining = text.length - block_start;
+        Block64 block = (remaining >= 64) ? load_block64(text.data + block_start)
+                                          : load_partial_block64(text.data + block_start, remaining, 0);
+
+        u64 mask = line_ending_mask(&block);
+        while (mask)
+        {
+            umm at = block_start + count_trailing_zeros64(mask);
+            mask = clear_lowest_bit(mask);
+            if (at < previous_end)
+                continue;
+
+            // Handle two-u8 line endings. ('\n' ^ '\r') is only produced by one of each.
+            umm end = at + 1;
+            if (end < text.length && (text.data[at] ^ text.data[end]) == ('\n' ^ '\r'))
+                end++;
+
+            previous_end = end;
+            if (end < text.length)
+                starts[count++] = end;
+        }
+    }
+
+    lk_region_resize_in_place(memory, starts, capacity * sizeof(umm), count * sizeof(umm));
+
+    result.count = count;
+    result.starts = starts;
+    return result;
+}
+
+
+String get_line(String text, Line_Index* index, umm line)
+{
+    DebugAssert(line < index->count);
+
+    umm start = index->starts[line];
+    umm end = (line + 1 < index->count) ? index->starts[line + 1] : text.length;
+
+    // Lines can't contain line ending characters, so the ones at the end are the line ending.
+    while (end > start && is_line_ending(text.data[end - 1]))
+        end--;
+
+    return substring(text, start, end - start);
+}
+
+
+// A line ending character followed by something else is the end of a line ending,
+// no matter how the characters before it pair up.
+static umm find_line_start_at_or_after(String text, umm offset)
+{
+    if (offset == 0)
+        offset = 1;
+
+    for (; offset < text.length; offset++)
+        if (is_line_ending(text.data[offset - 1]) && !is_line_ending(text.data[offset]))
+            return offset;
+
+    return text.length;
+}
+
+
+umm split_for_line_indexing(String text, umm part_count, String* parts)
+{
+    if (!part_count)
+        return 0;
+
+    umm count = 0;
+    umm start = 0;
+    umm part_length = text.length / part_count;
+
+    for (umm i = 1; i <= part_count && start < text.length; i++)
+    {
+        umm end = text.length;
+        if (i < part_count)
+        {
+            end = part_length * i;
+            if (end < start)
+                end = start;
+            end = find_line_start_at_or_after(text, end);
+        }
+
+        if (end > start)
+        {
+            parts[count++] = substring(text, start, end - start);
+            start = end;
+        }
+    }
+
+    return count;
+}
+
+
+Line_Index merge_line_indices(String text, String* parts, Line_Index* indices, umm part_count, Region* memory)
+{
+    Line_Index result = {};
+    for (umm i = 0; i < part_count; i++)
+        result.count += indices[i].count;
+
+    result.starts = LK_RegionArray(memory, umm, result.count);
+
+    umm* write = result.starts;
+    for (umm i = 0; i < part_count; i++)
+    {
+        DebugAssert(parts[i].data >= text.data && parts[i].data + parts[i].length <= text.data + text.length);
+        umm offset = parts[i].data - text.data;
+
+        Line_Index* index = &indices[i];
+        for (umm j = 0; j < index->count; j++)
+            *(write++) = index->starts[j] + offset;
+    }
+
+    return result;
+}
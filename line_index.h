@@ -0,0 +1,37 @@
+#pragma once
+
+/*
+ *
+ * -- random access to the lines of a large text
+ *
+ * Line endings are "\n", "\r", "\r\n" and "\n\r", the same as consume_line_preserve_whitespace,
+ * so line i of the index is the string the i-th call to consume_line_preserve_whitespace returns.
+ *
+ */
+
+#include "common.h"
+
+
+struct Line_Index
+{
+    umm  count;
+    umm* starts;  // Offset of the first byte of each line.
+};
+
+
+Line_Index build_line_index(String text, Region* memory = temp);
+
+// The line without its line ending.
+String get_line(String text, Line_Index* index, umm line);
+
+
+//
+// Parallel building.
+// split_for_line_indexing cuts the text into at most part_count parts, each starting at a line start.
+// Every part can then be indexed by build_line_index on a separate thread (each with its own region,
+// temp is not thread safe), and merge_line_indices puts the results back together.
+//
+
+
+umm split_for_line_indexing(String text, umm part_count, String* parts);  // Returns the number of parts used.
+Line_Index merge_line_indices(String text, String* parts, Line_Index* indices, umm part_count, Region* memory = temp);
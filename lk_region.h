@@ -87,6 +87,11 @@ extern "C"
 
 	void lk_region_free(LK_Region* region);
 
+	/* Resizes the most recent allocation without moving it.
+	This only works if the memory is at the top of the region, and the
+	new size still fits in the current page. Returns 0 if it can't be done. */
+	int lk_region_resize_in_place(LK_Region* region, void* memory, size_t old_size, size_t new_size);
+
 	/* Helper macros. */
 #define LK_RegionValue(region_ptr, type)                          ((type*) lk_region_alloc((region_ptr), sizeof(type),           LK__REGION_ALIGNOF(type)))
 #define LK_RegionArray(region_ptr, type, count)                   ((type*) lk_region_alloc((region_ptr), sizeof(type) * (count), LK__REGION_ALIGNOF(type)))
@@ -254,6 +259,22 @@ extern "C"
 		region->alloc_head = 0;
 	}
 
+	int lk_region_resize_in_place(LK_Region* region, void* memory, size_t old_size, size_t new_size)
+	{
+		char* start = (char*)memory;
+		if (start + old_size != (char*)region->cursor)
+			return 0;
+		if (start + new_size > (char*)region->page_end)
+			return 0;
+
+		/* Keep the free part of the page zeroed, like rewinding does. */
+		if (new_size < old_size)
+			ZeroMemory(start + new_size, old_size - new_size);
+
+		region->cursor = start + new_size;
+		return 1;
+	}
+
 	void lk_region_cursor(LK_Region* region, LK_Region_Cursor* cursor)
 	{
 		cursor->page_end = region->page_end;
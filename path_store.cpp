@@ -0,0 +1,396 @@
+#include "path_store.h"
+
+
+static String separator_chars = "/\\"_s;
+
+
+// A directory or file while building, before they are sorted and numbered.
+struct Path_Node
+{
+    u32 parent;  // Node index.
+    bool is_file;
+    String name;  // Points into the paths being added.
+    u32 id;
+};
+
+
+static u64 hash_node(u32 parent, bool is_file, String name)
+{
+    u64 hash = 0x9E3779B97F4A7C15 ^ (((u64) parent << 1) | is_file);
+
+    umm i = 0;
+    for (; i + 8 <= name.length; i += 8)
+    {
+        u64 chunk;
+        memcpy(&chunk, name.data + i, 8);
+        hash = (hash ^ chunk) * 0xFF51AFD7ED558CCD;
+        hash ^= hash >> 32;
+    }
+    for (; i < name.length; i++)
+        hash = (hash ^ name.data[i]) * 0x100000001B3;
+
+    hash ^= hash >> 29;
+    return hash;
+}
+
+
+// Subdirectories before files, each sorted by name.
+static bool comes_before(Path_Node* nodes, u32 a, u32 b)
+{
+    if (nodes[a].is_file != nodes[b].is_file)
+        return !nodes[a].is_file;
+    return compare(nodes[a].name, nodes[b].name) < 0;
+}
+
+static void sort_children(u32* children, umm count, Path_Node* nodes)
+{
+    while (count > 16)
+    {
+        u32 pivot = children[count / 2];
+        umm i = 0;
+        umm j = count - 1;
+        while (true)
+        {
+            while (comes_before(nodes, children[i], pivot)) i++;
+            while (comes_before(nodes, pivot, children[j])) j--;
+            if (i >= j)
+                break;
+
+            u32 temporary = children[i];
+            children[i++] = children[j];
+            children[j--] = temporary;
+        }
+
+        // Recurse into the smaller side, so the stack stays shallow.
+        umm left_count = j + 1;
+        if (left_count < count - left_count)
+        {
+            sort_children(children, left_count, nodes);
+            children += left_count;
+            count -= left_count;
+        }
+        else
+        {
+            sort_children(children + left_count, count - left_count, nodes);
+            count = left_count;
+        }
+    }
+
+    for (umm i = 1; i < count; i++)
+    {
+        u32 child = children[i];
+        umm j = i;
+        for (; j > 0 && comes_before(nodes, child, children[j - 1]); j--)
+            children[j] = children[j - 1];
+        children[j] = child;
+    }
+}
+
+
+bool build_path_store(Path_Store* store, String* paths, umm count, u32* ids, Region* memory)
+{
+    ZeroStruct(store);
+
+    Region scratch = {};
+    Defer(lk_region_free(&scratch));
+
+    // Each path component is at most one node, and there is the root.
+    umm max_nodes = 1;
+    for (umm i = 0; i < count; i++)
+    {
+        max_nodes++;
+        for (umm j = 0; j < paths[i].length; j++)
+            if (paths[i].data[j] == '/' || paths[i].data[j] == '\\')
+                max_nodes++;
+    }
+    if (max_nodes >= U32_MAX)
+        return false;
+
+    Path_Node* nodes = LK_RegionArray(&scratch, Path_Node, max_nodes);
+    nodes[0] = {};
+    nodes[0].parent = U32_MAX;
+    u32 node_count = 1;
+
+    umm table_size = 1024;
+    while (table_size < max_nodes * 2)
+        table_size *= 2;
+    u32* table = LK_RegionArray(&scratch, u32, table_size);
+    memset(table, 0xFF, table_size * sizeof(u32));
+
+    // Paths usually come grouped by directory, so the directory of the previous path is remembered
+    // and its components aren't looked up again.
+    String previous_directory = {};
+    u32 previous_directory_node = U32_MAX;
+
+    u32* path_nodes = LK_RegionArray(&scratch, u32, count);
+    for (umm i = 0; i < count; i++)
+    {
+        String rest = paths[i];
+        u32 node = 0;
+
+        umm last_slash = find_last_occurance_of_any(rest, separator_chars);
+        if (last_slash != NOT_FOUND && previous_directory_node != U32_MAX &&
+            substring(rest, 0, last_slash) == previous_directory)
+        {
+            node = previous_directory_node;
+            consume(&rest, last_slash + 1);
+        }
+
+        while (true)
+        {
+            umm slash = find_first_occurance_of_any(rest, separator_chars);
+            bool is_file = (slash == NOT_FOUND);
+            String name = is_file ? rest : substring(rest, 0, slash);
+
+            u32 parent = node;
+            umm slot = hash_node(parent, is_file, name) & (table_size - 1);
+            while (true)
+            {
+                node = table[slot];
+                if (node == U32_MAX)
+                {
+                    node = node_count++;
+                    nodes[node].parent = parent;
+                    nodes[node].is_file = is_file;
+                    nodes[node].name = name;
+                    table[slot] = node;
+                    break;
+                }
+
+                Path_Node* existing = &nodes[node];
+                if (existing->parent == parent && existing->is_file == is_file && existing->name == name)
+                    break;
+                slot = (slot + 1) & (table_size - 1);
+            }
+
+            if (is_file)
+            {
+                if (last_slash != NOT_FOUND)
+                {
+                    previous_directory = substring(paths[i], 0, last_slash);
+                    previous_directory_node = parent;
+                }
+                break;
+            }
+            consume(&rest, slash + 1);
+        }
+        path_nodes[i] = node;
+    }
+
+    // Group the children of each directory together.
+    u32* child_offsets = LK_RegionArray(&scratch, u32, node_count + 1);
+    memset(child_offsets, 0, (node_count + 1) * sizeof(u32));
+    for (u32 node = 1; node < node_count; node++)
+        child_offsets[nodes[node].parent + 1]++;
+    for (u32 node = 0; node < node_count; node++)
+        child_offsets[node + 1] += child_offsets[node];
+
+    u32* children = LK_RegionArray(&scratch, u32, node_count);
+    u32* child_counts = LK_RegionArray(&scratch, u32, node_count);
+    memset(child_counts, 0, node_count * sizeof(u32));
+    for (u32 node = 1; node < node_count; node++)
+    {
+        u32 parent = nodes[node].parent;
+        children[child_offsets[parent] + child_counts[parent]++] = node;
+    }
+
+    u32 directory_count = 0;
+    u32 file_count = 0;
+    umm name_bytes = 0;
+    for (u32 node = 0; node < node_count; node++)
+    {
+        if (nodes[node].is_file) file_count++;
+        else                     directory_count++;
+        name_bytes += nodes[node].name.length;
+    }
+    if (name_bytes > U32_MAX)
+        return false;
+
+    store->directories = LK_RegionArray(memory, Path_Directory, directory_count);
+    store->files = LK_RegionArray(memory, Path_File, file_count);
+    store->names = LK_RegionArray(memory, u8, name_bytes);
+
+    // Number the directories breadth first, so the subdirectories of each one get consecutive ids.
+    u32* directory_nodes = LK_RegionArray(&scratch, u32, directory_count);
+    directory_nodes[0] = 0;
+    store->directories[0] = {};
+    store->directories[0].parent = U32_MAX;
+
+    u32 next_directory = 1;
+    u32 next_file = 0;
+    u32 name_offset = 0;
+    for (u32 id = 0; id < next_directory; id++)
+    {
+        u32 node = directory_nodes[id];
+        u32* group = children + child_offsets[node];
+        u32 group_count = child_offsets[node + 1] - child_offsets[node];
+        sort_children(group, group_count, nodes);
+
+        Path_Directory* directory = &store->directories[id];
+        directory->first_directory = next_directory;
+        directory->first_file = next_file;
+
+        for (u32 i = 0; i < group_count; i++)
+        {
+            Path_Node* child = &nodes[group[i]];
+            copy(store->names + name_offset, child->name.data, child->name.length);
+
+            if (child->is_file)
+            {
+                Path_File* file = &store->files[next_file];
+                file->directory = id;
+                file->name_offset = name_offset;
+                file->name_length = (u32) child->name.length;
+                child->id = next_file++;
+            }
+            else
+            {
+                Path_Directory* subdirectory = &store->directories[next_directory];
+                subdirectory->parent = id;
+                subdirectory->name_offset = name_offset;
+                subdirectory->name_length = (u32) child->name.length;
+                directory_nodes[next_directory] = group[i];
+                child->id = next_directory++;
+            }
+
+            name_offset += (u32) child->name.length;
+        }
+
+        directory->directory_count = next_directory - directory->first_directory;
+        directory->file_count = next_file - directory->first_file;
+    }
+
+    store->directory_count = directory_count;
+    store->file_count = file_count;
+
+    if (ids)
+        for (umm i = 0; i < count; i++)
+            ids[i] = nodes[path_nodes[i]].id;
+
+    return true;
+}
+
+
+//
+// Lookups.
+//
+
+
+static u32 find_subdirectory(Path_Store* store, u32 directory, String name)
+{
+    Path_Directory* parent = &store->directories[directory];
+    u32 low = parent->first_directory;
+    u32 high = low + parent->directory_count;
+    while (low < high)
+    {
+        u32 middle = low + (high - low) / 2;
+        int result = compare(get_directory_name(store, middle), name);
+        if (!result)
+            return middle;
+
+        if (result < 0) low = middle + 1;
+        else            high = middle;
+    }
+    return U32_MAX;
+}
+
+static u32 find_file(Path_Store* store, u32 directory, String name)
+{
+    Path_Directory* parent = &store->directories[directory];
+    u32 low = parent->first_file;
+    u32 high = low + parent->file_count;
+    while (low < high)
+    {
+        u32 middle = low + (high - low) / 2;
+        int result = compare(get_file_name(store, middle), name);
+        if (!result)
+            return middle;
+
+        if (result < 0) low = middle + 1;
+        else            high = middle;
+    }
+    return U32_MAX;
+}
+
+
+u32 find_directory(Path_Store* store, String path)
+{
+    u32 directory = PATH_ROOT;
+    while (true)
+    {
+        umm slash = find_first_occurance_of_any(path, separator_chars);
+        String name = (slash == NOT_FOUND) ? path : substring(path, 0, slash);
+
+        directory = find_subdirectory(store, directory, name);
+        if (directory == U32_MAX || slash == NOT_FOUND)
+            return directory;
+        consume(&path, slash + 1);
+    }
+}
+
+
+u32 find_path(Path_Store* store, String path)
+{
+    u32 directory = PATH_ROOT;
+
+    umm slash = find_last_occurance_of_any(path, separator_chars);
+    if (slash != NOT_FOUND)
+    {
+        directory = find_directory(store, substring(path, 0, slash));
+        if (directory == U32_MAX)
+            return U32_MAX;
+        consume(&path, slash + 1);
+    }
+
+    return find_file(store, directory, path);
+}
+
+
+//
+// Building paths.
+//
+
+
+static String build_path(Path_Store* store, u32 directory, String name, Region* memory)
+{
+    umm length = name.length;
+    for (u32 at = directory; at != PATH_ROOT; at = store->directories[at].parent)
+        length += store->directories[at].name_length + 1;
+
+    String path;
+    path.length = length;
+    path.data = LK_RegionArray(memory, u8, length + 1);
+    path.data[length] = 0;
+
+    // Written back to front, walking up the directories.
+    u8* write = path.data + length - name.length;
+    copy(write, name.data, name.length);
+    for (u32 at = directory; at != PATH_ROOT; at = store->directories[at].parent)
+    {
+        String directory_name = get_directory_name(store, at);
+        *(--write) = '/';
+        write -= directory_name.length;
+        copy(write, directory_name.data, directory_name.length);
+    }
+
+    return path;
+}
+
+
+String get_path(Path_Store* store, u32 id, Region* memory)
+{
+    return build_path(store, store->files[id].directory, get_file_name(store, id), memory);
+}
+
+
+String get_directory_path(Path_Store* store, u32 directory, Region* memory)
+{
+    if (directory == PATH_ROOT)
+    {
+        String path = {};
+        path.data = LK_RegionArray(memory, u8, 1);
+        path.data[0] = 0;
+        return path;
+    }
+    return build_path(store, store->directories[directory].parent, get_directory_name(store, directory), memory);
+}
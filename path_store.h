@@ -0,0 +1,99 @@
+#pragma once
+
+/*
+ *
+ * -- compact storage for many file paths
+ *
+ * Dataset paths share long directory prefixes. Path_Store keeps each directory once, as a trie
+ * of path components, and each file as its directory plus its name. Files are referred to by
+ * 32-bit ids, and full paths are only built when asked for:
+ *
+ *     u32* ids = LK_RegionArray(temp, u32, count);
+ *     build_path_store(&store, paths, count, ids, &memory);
+ *     ...
+ *     String name = get_file_name(&store, ids[i]);  // Points into the store.
+ *     String path = get_path(&store, ids[i]);       // Built in temp.
+ *
+ * Subdirectories and files of each directory are sorted by name and stored next to each other,
+ * so finding a path is a binary search per component.
+ * Both slashes separate components, built paths use forward slashes.
+ *
+ */
+
+#include "common.h"
+
+
+constexpr u32 PATH_ROOT = 0;  // The directory relative paths start in. Absolute paths start in its subdirectory "".
+
+
+struct Path_Directory
+{
+    u32 parent;  // U32_MAX for PATH_ROOT.
+    u32 name_offset;
+    u32 name_length;
+    u32 first_directory;
+    u32 directory_count;
+    u32 first_file;
+    u32 file_count;
+};
+
+struct Path_File
+{
+    u32 directory;
+    u32 name_offset;
+    u32 name_length;
+};
+
+struct Path_Store
+{
+    Path_Directory* directories;
+    u32 directory_count;
+
+    Path_File* files;
+    u32 file_count;
+
+    u8* names;  // All directory and file names, one after another.
+};
+
+
+// If ids isn't NULL, it gets the id of each path. Paths that are the same get the same id.
+// Returns false if there are too many paths or too many bytes of names for 32 bits.
+bool build_path_store(Path_Store* store, String* paths, umm count, u32* ids = NULL, Region* memory = temp);
+
+// Returns U32_MAX if the store doesn't have the path.
+u32 find_path(Path_Store* store, String path);
+u32 find_directory(Path_Store* store, String path);
+
+String get_path(Path_Store* store, u32 id, Region* memory = temp);
+String get_directory_path(Path_Store* store, u32 directory, Region* memory = temp);
+
+
+inline String get_file_name(Path_Store* store, u32 id)
+{
+    Path_File* file = &store->files[id];
+
+    String name;
+    name.length = file->name_length;
+    name.data = store->names + file->name_offset;
+    return name;
+}
+
+inline String get_file_name_without_extension(Path_Store* store, u32 id)
+{
+    return get_file_name_without_extension(get_file_name(store, id));
+}
+
+inline String get_directory_name(Path_Store* store, u32 directory)
+{
+    Path_Directory* entry = &store->directories[directory];
+
+    String name;
+    name.length = entry->name_length;
+    name.data = store->names + entry->name_offset;
+    return name;
+}
+
+inline u32 get_parent_directory(Path_Store* store, u32 id)
+{
+    return store->files[id].directory;
+}
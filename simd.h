@@ -0,0 +1,132 @@
+#pragma once
+
+/*
+ *
+ * -- helpers for classifying text 64 bytes at a time
+ *
+ * Each 64 byte block is turned into 64-bit masks with one bit per byte (bit i is byte i),
+ * which are then walked with count_trailing_zeros64 and friends.
+ * Uses SSE2 when available (it always is on x64), and plain loops otherwise.
+ * SIMD_SSSE3 is also defined when the compiler targets SSSE3, for code that needs byte shuffles,
+ * and SIMD_AVX2 when it targets AVX2, for code that does the same on 32 bytes at a time.
+ * SIMD_PCLMUL is for carry-less multiplication, which checksums use.
+ *
+ */
+
+#include "common.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// Byte shuffles. Compilers only define these when told to target SSSE3 or newer (-mssse3, /arch:AVX).
+#if defined(__SSSE3__) || defined(__AVX__)
+#define SIMD_SSSE3 1
+#include <tmmintrin.h>
+#endif
+
+// 256-bit integer operations (-mavx2, /arch:AVX2).
+#if defined(__AVX2__)
+#define SIMD_AVX2 1
+#include <immintrin.h>
+#endif
+
+// Carry-less multiplication (-mpclmul). MSVC doesn't say, but every CPU with AVX2 has it.
+#if defined(__PCLMUL__) || (defined(_MSC_VER) && defined(__AVX2__))
+#define SIMD_PCLMUL 1
+#include <wmmintrin.h>
+#endif
+
+
+struct Block64
+{
+#ifdef SIMD_SSE2
+    __m128i lanes[4];
+#else
+    u8 bytes[64];
+#endif
+};
+
+
+inline Block64 load_block64(const u8* data)
+{
+    Block64 block;
+#ifdef SIMD_SSE2
+    block.lanes[0] = _mm_loadu_si128((const __m128i*)(data +  0));
+    block.lanes[1] = _mm_loadu_si128((const __m128i*)(data + 16));
+    block.lanes[2] = _mm_loadu_si128((const __m128i*)(data + 32));
+    block.lanes[3] = _mm_loadu_si128((const __m128i*)(data + 48));
+#else
+    memcpy(block.bytes, data, 64);
+#endif
+    return block;
+}
+
+// For the tail of the input. Bytes past 'length' are set to 'padding'.
+inline Block64 load_partial_block64(const u8* data, umm length, u8 padding)
+{
+    DebugAssert(length < 64);
+
+    u8 buffer[64];
+    memset(buffer, padding, 64);
+    memcpy(buffer, data, length);
+    return load_block64(buffer);
+}
+
+
+inline u64 equal_mask(Block64* block, u8 character)
+{
+#ifdef SIMD_SSE2
+    __m128i needle = _mm_set1_epi8((char) character);
+    u64 m0 = (u32) _mm_movemask_epi8(_mm_cmpeq_epi8(block->lanes[0], needle));
+    u64 m1 = (u32) _mm_movemask_epi8(_mm_cmpeq_epi8(block->lanes[1], needle));
+    u64 m2 = (u32) _mm_movemask_epi8(_mm_cmpeq_epi8(block->lanes[2], needle));
+    u64 m3 = (u32) _mm_movemask_epi8(_mm_cmpeq_epi8(block->lanes[3], needle));
+    return m0 | (m1 << 16) | (m2 << 32) | (m3 << 48);
+#else
+    u64 mask = 0;
+    for (u32 i = 0; i < 64; i++)
+        if (block->bytes[i] == character)
+            mask |= (u64) 1 << i;
+    return mask;
+#endif
+}
+
+// Bytes that are less than or equal to 'character', as unsigned. Good for finding control characters.
+inline u64 less_or_equal_mask(Block64* block, u8 character)
+{
+#ifdef SIMD_SSE2
+    __m128i limit = _mm_set1_epi8((char) character);
+    u64 m0 = (u32) _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(block->lanes[0], limit), block->lanes[0]));
+    u64 m1 = (u32) _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(block->lanes[1], limit), block->lanes[1]));
+    u64 m2 = (u32) _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(block->lanes[2], limit), block->lanes[2]));
+    u64 m3 = (u32) _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(block->lanes[3], limit), block->lanes[3]));
+    return m0 | (m1 << 16) | (m2 << 32) | (m3 << 48);
+#else
+    u64 mask = 0;
+    for (u32 i = 0; i < 64; i++)
+        if (block->bytes[i] <= character)
+            mask |= (u64) 1 << i;
+    return mask;
+#endif
+}
+
+
+// Bit i of the result is the xor of bits 0..i of the input.
+// Turns a mask of quote characters into a mask of the bytes inside quotes.
+inline u64 prefix_xor(u64 mask)
+{
+    mask ^= mask << 1;
+    mask ^= mask << 2;
+    mask ^= mask << 4;
+    mask ^= mask << 8;
+    mask ^= mask << 16;
+    mask ^= mask << 32;
+    return mask;
+}
+
+inline u64 clear_lowest_bit(u64 mask)
+{
+    return mask & (mask - 1);
+}
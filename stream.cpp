@@ -0,0 +1,278 @@
+#include "stream.h"
+
+#include <stdlib.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+
+// Fills the back buffer while the front one is being read.
+struct Stream_Worker
+{
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable condition;
+
+    // Protected by the mutex.
+    bool quit;
+    bool fill_requested;
+    bool filled;
+    u8* target;
+    umm filled_length;
+    bool filled_to_end;
+    bool filled_with_error;
+};
+
+
+static void fill(Stream_Reader* reader, u8* target, umm* length, bool* reached_end, bool* error)
+{
+    *length = 0;
+    *reached_end = false;
+    *error = false;
+
+    // Pipes and sockets return less than asked for, keep going until the chunk is full.
+    while (*length < reader->chunk_size)
+    {
+        imm result = reader->read(reader->user_data, target + *length, reader->chunk_size - *length);
+        if (result <= 0)
+        {
+            *reached_end = true;
+            *error = result < 0;
+            return;
+        }
+        *length += result;
+    }
+}
+
+
+static void run_worker(Stream_Reader* reader, Stream_Worker* worker)
+{
+    while (true)
+    {
+        u8* target;
+        {
+            std::unique_lock<std::mutex> lock(worker->mutex);
+            worker->condition.wait(lock, [worker] { return worker->quit || worker->fill_requested; });
+            if (worker->quit)
+                return;
+
+            worker->fill_requested = false;
+            target = worker->target;
+        }
+
+        umm length;
+        bool reached_end, error;
+        fill(reader, target, &length, &reached_end, &error);
+
+        {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            worker->filled = true;
+            worker->filled_length = length;
+            worker->filled_to_end = reached_end;
+            worker->filled_with_error = error;
+        }
+        worker->condition.notify_all();
+    }
+}
+
+
+static void request_fill(Stream_Reader* reader, u32 buffer_index)
+{
+    Stream_Worker* worker = reader->worker;
+    {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        worker->fill_requested = true;
+        worker->target = reader->buffers[buffer_index] + reader->max_token_size;
+    }
+    worker->condition.notify_all();
+}
+
+
+void begin_stream(Stream_Reader* reader, Stream_Read_Function* read, void* user_data, umm chunk_size, umm max_token_size)
+{
+    ZeroStruct(reader);
+    reader->read = read;
+    reader->user_data = user_data;
+    reader->chunk_size = chunk_size;
+    reader->max_token_size = max_token_size;
+
+    for (u32 i = 0; i < 2; i++)
+        reader->buffers[i] = (u8*) malloc(max_token_size + chunk_size);
+
+    // The front buffer starts out empty, the first ensure waits for the back one.
+    reader->front = 0;
+    reader->available.data = reader->buffers[0] + max_token_size;
+    reader->available.length = 0;
+
+    reader->worker = new Stream_Worker();
+    reader->worker->thread = std::thread(run_worker, reader, reader->worker);
+    request_fill(reader, 1);
+}
+
+
+void close_stream(Stream_Reader* reader)
+{
+    if (reader->worker)
+    {
+        {
+            std::lock_guard<std::mutex> lock(reader->worker->mutex);
+            reader->worker->quit = true;
+        }
+        reader->worker->condition.notify_all();
+        reader->worker->thread.join();
+        delete reader->worker;
+    }
+
+    if (reader->owns_file)
+    {
+#ifdef _WIN32
+        CloseHandle((HANDLE) reader->user_data);
+#else
+        close((int)(imm) reader->user_data);
+#endif
+    }
+
+    free(reader->buffers[0]);
+    free(reader->buffers[1]);
+    ZeroStruct(reader);
+}
+
+
+bool ensure(Stream_Reader* reader, umm count)
+{
+    while (reader->available.length < count)
+    {
+        if (reader->end_of_input)
+            return false;
+
+        if (count > reader->max_token_size)
+        {
+            reader->failed = true;
+            return false;
+        }
+
+        Stream_Worker* worker = reader->worker;
+        umm length;
+        bool reached_end;
+        {
+            std::unique_lock<std::mutex> lock(worker->mutex);
+            worker->condition.wait(lock, [worker] { return worker->filled; });
+
+            worker->filled = false;
+            length = worker->filled_length;
+            reached_end = worker->filled_to_end;
+            if (worker->filled_with_error)
+                reader->failed = true;
+        }
+
+        // Carry the unread bytes over to just before the new data.
+        u32 back = 1 - reader->front;
+        u8* data = reader->buffers[back] + reader->max_token_size;
+        String tail = reader->available;
+        move(data - tail.length, tail.data, tail.length);
+
+        reader->available.data = data - tail.length;
+        reader->available.length = tail.length + length;
+        reader->front = back;
+        reader->end_of_input = reached_end;
+
+        // The old front buffer is free now, start filling it.
+        if (!reached_end)
+            request_fill(reader, 1 - back);
+    }
+
+    return true;
+}
+
+
+bool read_line(Stream_Reader* reader, String* line)
+{
+    umm searched = 0;
+    while (true)
+    {
+        String available = reader->available;
+        umm line_length = find_line_ending(substring(available, searched, available.length - searched));
+
+        // A line ending at the very end could be the first half of a two character one.
+        if (line_length != NOT_FOUND && (searched + line_length + 1 < available.length || reader->end_of_input))
+            break;
+
+        if (line_length == NOT_FOUND)
+            searched = available.length;
+
+        if (!ensure(reader, available.length + 1))
+        {
+            if (reader->failed || !reader->available)
+                return false;
+            break;
+        }
+    }
+
+    *line = consume_line_preserve_whitespace(&reader->available);
+    return true;
+}
+
+
+#ifdef _WIN32
+
+static imm read_from_file(void* user_data, void* buffer, umm size)
+{
+    DWORD read_size;
+    if (size > 0x40000000)
+        size = 0x40000000;
+    if (!ReadFile((HANDLE) user_data, buffer, (DWORD) size, &read_size, NULL))
+        return -1;
+    return read_size;
+}
+
+bool open_stream(Stream_Reader* reader, const char* path, umm chunk_size, umm max_token_size)
+{
+    String16 wide_path = convert_utf8_to_utf16(wrap_string(path));
+    HANDLE handle = CreateFileW((LPCWSTR) wide_path.data, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (handle == INVALID_HANDLE_VALUE)
+        return false;
+
+    begin_stream(reader, read_from_file, handle, chunk_size, max_token_size);
+    reader->owns_file = true;
+    return true;
+}
+
+#else
+
+static imm read_from_file(void* user_data, void* buffer, umm size)
+{
+    while (true)
+    {
+        ssize_t result = read((int)(imm) user_data, buffer, size);
+        if (result < 0 && errno == EINTR)
+            continue;
+        return result;
+    }
+}
+
+bool open_stream(Stream_Reader* reader, const char* path, umm chunk_size, umm max_token_size)
+{
+    int descriptor = open(path, O_RDONLY | O_CLOEXEC);
+    if (descriptor < 0)
+        return false;
+
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(descriptor, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    begin_stream(reader, read_from_file, (void*)(imm) descriptor, chunk_size, max_token_size);
+    reader->owns_file = true;
+    return true;
+}
+
+#endif
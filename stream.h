@@ -0,0 +1,62 @@
+#pragma once
+
+/*
+ *
+ * -- reading inputs that don't fit in memory
+ *
+ * Stream_Reader holds two chunks of the input. While one is being read, a background thread
+ * fills the other. The unread bytes are always one contiguous String, so the text and binary
+ * reading utilities from common.h work on it directly:
+ *
+ *     while (ensure(&reader, 8))
+ *         read_u64be(&reader.available, &value);
+ *
+ *     String line;
+ *     while (read_line(&reader, &line))
+ *         ...
+ *
+ * When ensure needs bytes from the next chunk, the few unread bytes at the end of the current one
+ * are copied in front of the next one, so nothing straddles a chunk edge. That is the only copy.
+ * Strings pointing into 'available' are valid until the next call to ensure or read_line.
+ *
+ */
+
+#include "common.h"
+
+
+// Returns the number of bytes read, 0 at the end of input, or a negative number on error.
+typedef imm Stream_Read_Function(void* user_data, void* buffer, umm size);
+
+struct Stream_Worker;
+
+struct Stream_Reader
+{
+    String available;  // The unread bytes in memory.
+    bool failed;       // A read failed, or ensure was asked for more than max_token_size.
+
+    // Internal.
+    Stream_Read_Function* read;
+    void* user_data;
+    bool owns_file;
+
+    umm chunk_size;
+    umm max_token_size;
+    u8* buffers[2];  // Each has max_token_size bytes of room for carried over bytes, followed by chunk_size bytes of input.
+    u32 front;
+    bool end_of_input;  // Nothing more is coming after 'available'.
+
+    Stream_Worker* worker;
+};
+
+
+void begin_stream(Stream_Reader* reader, Stream_Read_Function* read, void* user_data,
+                  umm chunk_size = 1024 * 1024, umm max_token_size = 64 * 1024);
+bool open_stream(Stream_Reader* reader, const char* path,
+                 umm chunk_size = 1024 * 1024, umm max_token_size = 64 * 1024);  // Path is UTF-8.
+void close_stream(Stream_Reader* reader);
+
+// Makes sure at least 'count' bytes are available. Returns false if the input ends sooner.
+bool ensure(Stream_Reader* reader, umm count);
+
+// Like consume_line_preserve_whitespace on the whole input. Lines can't be longer than max_token_size.
+bool read_line(Stream_Reader* reader, String* line);
@@ -0,0 +1,48 @@
+#pragma once
+
+/*
+ *
+ * -- compact arrays of small integers
+ *
+ * Stream-VByte stores each u32 in 1 to 4 bytes. The byte counts are packed two bits each into
+ * control bytes, which are all written before the data bytes, so a group of four values is
+ * decoded with a single byte shuffle instead of a branch per byte like with varints.
+ * Decoding uses SSSE3 when the compiler targets it, and a scalar loop otherwise.
+ *
+ * Correlated values, like frame numbers or the box coordinates in consecutive frames, shrink a lot
+ * more when delta coded first. The _deltas versions store the zigzag encoded difference from the
+ * previous value, so sequences that go down stay small too.
+ *
+ *     write_stream_vbyte_deltas(&builder, frame_numbers, count);
+ *     ...
+ *     if (!read_stream_vbyte_deltas(&input, frame_numbers, count))
+ *         return false;
+ *
+ * The count isn't stored, write it before the array if the reader doesn't know it.
+ *
+ */
+
+#include "common.h"
+
+
+// The most bytes writing 'count' values can take.
+inline umm get_stream_vbyte_max_length(umm count)
+{
+    return (count + 3) / 4 + count * 4;
+}
+
+
+// A Binary_Writer needs room for get_stream_vbyte_max_length(count) bytes, even though less is usually written.
+void write_stream_vbyte(Binary_Writer* writer, const u32* values, umm count);
+void write_stream_vbyte(String_Builder* builder, const u32* values, umm count);
+bool read_stream_vbyte(String* string, u32* values, umm count);
+
+void write_stream_vbyte_deltas(Binary_Writer* writer, const u32* values, umm count, u32 previous = 0);
+void write_stream_vbyte_deltas(String_Builder* builder, const u32* values, umm count, u32 previous = 0);
+bool read_stream_vbyte_deltas(String* string, u32* values, umm count, u32 previous = 0);
+
+
+// Delta coding on its own, in place, for combining with other encodings.
+// Each value is replaced by the zigzag encoded difference from the one before it, the first one from 'previous'.
+void encode_deltas(u32* values, umm count, u32 previous = 0);
+void decode_deltas(u32* values, umm count, u32 previous = 0);
@@ -0,0 +1,404 @@
+#include "text_buffer.h"
+
+#include <stdlib.h>
+
+
+//
+//
+// -- gap buffer
+//
+//
+
+
+void free_gap_buffer(Gap_Buffer* buffer)
+{
+    free(buffer->data);
+    ZeroStruct(buffer);
+}
+
+
+void clear(Gap_Buffer* buffer)
+{
+    buffer->gap_start = 0;
+    buffer->gap_end = buffer->capacity;
+}
+
+
+// Moves the gap so that it starts at the given text offset.
+static void move_gap(Gap_Buffer* buffer, umm offset)
+{
+    if (offset < buffer->gap_start)
+    {
+        umm count = buffer->gap_start - offset;
+        buffer->gap_start -= count;
+        buffer->gap_end -= count;
+        move(buffer->data + buffer->gap_end, buffer->data + buffer->gap_start, count);
+    }
+    else if (offset > buffer->gap_start)
+    {
+        umm count = offset - buffer->gap_start;
+        move(buffer->data + buffer->gap_start, buffer->data + buffer->gap_end, count);
+        buffer->gap_start += count;
+        buffer->gap_end += count;
+    }
+}
+
+
+// Makes the gap larger than insert_length. It never closes completely,
+// so flatten always has room for the null terminator.
+static void maybe_resize(Gap_Buffer* buffer, umm insert_length)
+{
+    if (buffer->gap_end - buffer->gap_start > insert_length)
+        return;
+
+    umm length = get_length(buffer);
+    umm new_capacity = buffer->capacity;
+    if (!new_capacity) new_capacity = 64;
+
+    // growth factor of 1.5
+    do new_capacity = new_capacity + (new_capacity >> 1);
+    while (new_capacity - length <= insert_length);
+
+    // Keep the text after the gap at the end of the buffer.
+    umm tail_length = buffer->capacity - buffer->gap_end;
+    buffer->data = (u8*) realloc(buffer->data, new_capacity);
+    move(buffer->data + new_capacity - tail_length, buffer->data + buffer->gap_end, tail_length);
+
+    buffer->gap_end = new_capacity - tail_length;
+    buffer->capacity = new_capacity;
+}
+
+
+void append(Gap_Buffer* buffer, const void* data, umm length)
+{
+    insert(buffer, get_length(buffer), data, length);
+}
+
+
+void insert(Gap_Buffer* buffer, umm at_offset, const void* data, umm length)
+{
+    DebugAssert(at_offset <= get_length(buffer));
+
+    maybe_resize(buffer, length);
+    move_gap(buffer, at_offset);
+
+    copy(buffer->data + buffer->gap_start, data, length);
+    buffer->gap_start += length;
+}
+
+
+void remove(Gap_Buffer* buffer, umm at_offset, umm length)
+{
+    DebugAssert(at_offset + length <= get_length(buffer));
+
+    // Removing right before the gap (backspacing) doesn't need to move anything.
+    if (at_offset + length == buffer->gap_start)
+    {
+        buffer->gap_start = at_offset;
+        return;
+    }
+
+    move_gap(buffer, at_offset);
+    buffer->gap_end += length;
+}
+
+
+String flatten(Gap_Buffer* buffer)
+{
+    maybe_resize(buffer, 0);
+
+    umm length = get_length(buffer);
+    move_gap(buffer, length);
+    buffer->data[length] = 0;
+
+    String result;
+    result.length = length;
+    result.data = buffer->data;
+    return result;
+}
+
+
+
+
+//
+//
+// -- rope
+//
+//
+
+
+static Rope_Chunk* allocate_chunk(Rope* rope)
+{
+    DebugAssert(rope->region);
+    return allocate(rope->region, &rope->free_chunks);
+}
+
+
+// Opens up 'count' entries in the index at 'at_index'.
+static void insert_index_entries(Rope* rope, umm at_index, umm count)
+{
+    umm new_count = rope->chunk_count + count;
+    if (new_count > rope->chunk_capacity)
+    {
+        umm new_capacity = rope->chunk_capacity;
+        if (!new_capacity) new_capacity = 16;
+
+        // growth factor of 1.5
+        while (new_capacity < new_count)
+            new_capacity = new_capacity + (new_capacity >> 1);
+
+        rope->index = (Rope_Index_Entry*) realloc(rope->index, new_capacity * sizeof(Rope_Index_Entry));
+        rope->chunk_capacity = new_capacity;
+    }
+
+    Rope_Index_Entry* at = rope->index + at_index;
+    move(at + count, at, (rope->chunk_count - at_index) * sizeof(Rope_Index_Entry));
+    rope->chunk_count = new_count;
+}
+
+// Retires 'count' chunks starting at 'at_index' and removes them from the index.
+static void remove_index_entries(Rope* rope, umm at_index, umm count)
+{
+    Rope_Index_Entry* at = rope->index + at_index;
+    for (umm i = 0; i < count; i++)
+        retire(&rope->free_chunks, at[i].chunk);
+
+    move(at, at + count, (rope->chunk_count - at_index - count) * sizeof(Rope_Index_Entry));
+    rope->chunk_count -= count;
+}
+
+// Merges a chunk with the one after it, if they fit together.
+static void maybe_merge_with_next(Rope* rope, umm index)
+{
+    if (index + 1 >= rope->chunk_count)
+        return;
+
+    Rope_Index_Entry* entry = &rope->index[index];
+    Rope_Index_Entry* next  = &rope->index[index + 1];
+    if (entry->length + next->length > ROPE_CHUNK_SIZE)
+        return;
+
+    copy(entry->chunk->data + entry->length, next->chunk->data, next->length);
+    entry->length += next->length;
+    remove_index_entries(rope, index + 1, 1);
+}
+
+
+// Finds the chunk that contains the offset. Offsets at a chunk boundary
+// resolve to the end of the earlier chunk, so appends don't need a new one.
+static umm locate(Rope* rope, umm offset, umm* offset_in_chunk)
+{
+    DebugAssert(offset <= rope->length);
+    DebugAssert(rope->chunk_count);
+
+    umm index;
+    if (offset > rope->length / 2)
+    {
+        // Closer to the end, walk backwards.
+        umm from_end = rope->length - offset;
+        index = rope->chunk_count - 1;
+        while (from_end >= rope->index[index].length && index > 0)
+        {
+            from_end -= rope->index[index].length;
+            index--;
+        }
+        offset = rope->index[index].length - from_end;
+    }
+    else
+    {
+        index = 0;
+        while (offset > rope->index[index].length)
+        {
+            offset -= rope->index[index].length;
+            index++;
+        }
+    }
+
+    *offset_in_chunk = offset;
+    return index;
+}
+
+
+void free_rope(Rope* rope)
+{
+    clear(rope);
+    free(rope->index);
+
+    rope->index = NULL;
+    rope->chunk_capacity = 0;
+}
+
+
+void clear(Rope* rope)
+{
+    remove_index_entries(rope, 0, rope->chunk_count);
+    rope->length = 0;
+}
+
+
+void append(Rope* rope, const void* data, umm length)
+{
+    insert(rope, rope->length, data, length);
+}
+
+
+void insert(Rope* rope, umm at_offset, const void* data, umm length)
+{
+    DebugAssert(at_offset <= rope->length);
+    if (!length)
+        return;
+
+    if (!rope->chunk_count)
+    {
+        insert_index_entries(rope, 0, 1);
+        rope->index[0].chunk = allocate_chunk(rope);
+        rope->index[0].length = 0;
+    }
+
+    umm offset;
+    umm index = locate(rope, at_offset, &offset);
+    rope->length += length;
+
+    Rope_Index_Entry* entry = &rope->index[index];
+    Rope_Chunk* chunk = entry->chunk;
+    const u8* source = (const u8*) data;
+
+    // Fits in the chunk, just make room.
+    if (entry->length + length <= ROPE_CHUNK_SIZE)
+    {
+        move(chunk->data + offset + length, chunk->data + offset, entry->length - offset);
+        copy(chunk->data + offset, source, length);
+        entry->length += length;
+        return;
+    }
+
+    // Otherwise split the chunk: the head stays, followed by the inserted data
+    // in as many full chunks as needed, followed by the old tail.
+    umm tail_length = entry->length - offset;
+    Rope_Chunk* tail = NULL;
+    if (tail_length)
+    {
+        tail = allocate_chunk(rope);
+        copy(tail->data, chunk->data + offset, tail_length);
+    }
+
+    umm first_length = ROPE_CHUNK_SIZE - offset;
+    if (first_length > length)
+        first_length = length;
+
+    copy(chunk->data + offset, source, first_length);
+    entry->length = offset + first_length;
+    source += first_length;
+
+    umm remaining = length - first_length;
+    umm new_chunk_count = (remaining + ROPE_CHUNK_SIZE - 1) / ROPE_CHUNK_SIZE;
+    umm last_length = new_chunk_count ? remaining - (new_chunk_count - 1) * ROPE_CHUNK_SIZE : entry->length;
+    bool merge_tail = tail && last_length + tail_length <= ROPE_CHUNK_SIZE;
+
+    insert_index_entries(rope, index + 1, new_chunk_count + ((tail && !merge_tail) ? 1 : 0));
+
+    for (umm i = 0; i < new_chunk_count; i++)
+    {
+        umm chunk_length = remaining < ROPE_CHUNK_SIZE ? remaining : ROPE_CHUNK_SIZE;
+
+        Rope_Index_Entry* new_entry = &rope->index[index + 1 + i];
+        new_entry->chunk = allocate_chunk(rope);
+        new_entry->length = chunk_length;
+        copy(new_entry->chunk->data, source, chunk_length);
+
+        source += chunk_length;
+        remaining -= chunk_length;
+    }
+
+    if (tail)
+    {
+        Rope_Index_Entry* last = &rope->index[index + new_chunk_count];
+        if (merge_tail)
+        {
+            copy(last->chunk->data + last->length, tail->data, tail_length);
+            last->length += tail_length;
+            retire(&rope->free_chunks, tail);
+        }
+        else
+        {
+            last[1].chunk = tail;
+            last[1].length = tail_length;
+        }
+    }
+}
+
+
+void remove(Rope* rope, umm at_offset, umm length)
+{
+    DebugAssert(at_offset + length <= rope->length);
+    if (!length)
+        return;
+
+    umm offset;
+    umm index = locate(rope, at_offset, &offset);
+    if (offset == rope->index[index].length)
+    {
+        index++;
+        offset = 0;
+    }
+
+    rope->length -= length;
+
+    // Only the first and the last touched chunk can keep some of their text,
+    // the ones in between become empty.
+    umm first_index = index;
+    umm empty_start = NOT_FOUND;
+    umm empty_count = 0;
+
+    while (length)
+    {
+        Rope_Index_Entry* entry = &rope->index[index];
+
+        umm count = entry->length - offset;
+        if (count > length)
+            count = length;
+
+        u8* at = entry->chunk->data + offset;
+        move(at, at + count, entry->length - offset - count);
+        entry->length -= count;
+        length -= count;
+
+        if (!entry->length)
+        {
+            if (empty_start == NOT_FOUND)
+                empty_start = index;
+            empty_count++;
+        }
+
+        index++;
+        offset = 0;
+    }
+
+    if (empty_count)
+        remove_index_entries(rope, empty_start, empty_count);
+
+    // Keep the chunks around the edit from fragmenting.
+    if (first_index > 0)
+        first_index--;
+    maybe_merge_with_next(rope, first_index);
+    maybe_merge_with_next(rope, first_index);
+}
+
+
+String flatten(Rope* rope, Region* memory)
+{
+    String result;
+    result.length = rope->length;
+    result.data = LK_RegionArray(memory, u8, rope->length + 1);
+
+    u8* write = result.data;
+    for (umm i = 0; i < rope->chunk_count; i++)
+    {
+        Rope_Index_Entry* entry = &rope->index[i];
+        copy(write, entry->chunk->data, entry->length);
+        write += entry->length;
+    }
+    *write = 0;
+
+    return result;
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+/*
+ *
+ * -- text containers for heavy editing, companions to String_Builder
+ *
+ */
+
+#include "common.h"
+
+
+//
+// Gap buffer.
+// The text is kept in one heap buffer with a gap at the last edit position, so edits
+// close to each other only move the bytes between them. Good for interactive editing.
+//
+
+
+struct Gap_Buffer
+{
+    u8* data;
+    umm capacity;
+    umm gap_start;
+    umm gap_end;
+};
+
+
+void free_gap_buffer(Gap_Buffer* buffer);
+void clear(Gap_Buffer* buffer);
+void append(Gap_Buffer* buffer, const void* data, umm length);
+void insert(Gap_Buffer* buffer, umm at_offset, const void* data, umm length);
+void remove(Gap_Buffer* buffer, umm at_offset, umm length);
+
+// Moves the gap to the end and returns the text. No copy is made, so the string is
+// only valid until the next edit. It is null terminated.
+String flatten(Gap_Buffer* buffer);
+
+
+inline umm get_length(Gap_Buffer* buffer)
+{
+    return buffer->capacity - (buffer->gap_end - buffer->gap_start);
+}
+
+inline void append(Gap_Buffer* buffer, String string)
+{
+    append(buffer, string.data, string.length);
+}
+
+inline void append(Gap_Buffer* buffer, const char* c_string)
+{
+    append(buffer, c_string, length_of_c_style_string(c_string));
+}
+
+inline void insert(Gap_Buffer* buffer, umm at_offset, String string)
+{
+    insert(buffer, at_offset, string.data, string.length);
+}
+
+inline void insert(Gap_Buffer* buffer, umm at_offset, const char* c_string)
+{
+    insert(buffer, at_offset, c_string, length_of_c_style_string(c_string));
+}
+
+
+//
+// Rope.
+// The text is split into fixed size chunks allocated in a region, and indexed by an array
+// of chunk pointers. An edit only moves bytes within the chunks it touches (and pointers in
+// the index), so its cost doesn't depend on where in a large document it happens.
+// Chunks emptied by removals are retired and reused.
+//
+
+
+constexpr umm ROPE_CHUNK_SIZE = 4096 - sizeof(void*);
+
+struct Rope_Chunk
+{
+    RetirementLink(Rope_Chunk)
+    u8 data[ROPE_CHUNK_SIZE];
+};
+
+// Lengths are kept in the index rather than in the chunks, so finding an offset
+// walks one contiguous array instead of touching every chunk.
+struct Rope_Index_Entry
+{
+    Rope_Chunk* chunk;
+    umm length;
+};
+
+struct Rope
+{
+    Region* region;  // Where the chunks are allocated. Must be set before use.
+    Retirement_List<Rope_Chunk> free_chunks;
+
+    Rope_Index_Entry* index;  // Heap allocated.
+    umm chunk_count;
+    umm chunk_capacity;
+
+    umm length;
+};
+
+
+void free_rope(Rope* rope);  // Frees the index. Chunks are retired, their memory belongs to the region.
+void clear(Rope* rope);
+void append(Rope* rope, const void* data, umm length);
+void insert(Rope* rope, umm at_offset, const void* data, umm length);
+void remove(Rope* rope, umm at_offset, umm length);
+
+// Copies the text into one contiguous string in memory.
+String flatten(Rope* rope, Region* memory = temp);
+
+
+// Chunk access, for walking the text without flattening it.
+inline umm get_chunk_count(Rope* rope)
+{
+    return rope->chunk_count;
+}
+
+inline String get_chunk(Rope* rope, umm index)
+{
+    DebugAssert(index < rope->chunk_count);
+    Rope_Index_Entry* entry = &rope->index[index];
+
+    String result;
+    result.length = entry->length;
+    result.data = entry->chunk->data;
+    return result;
+}
+
+inline void append(Rope* rope, String string)
+{
+    append(rope, string.data, string.length);
+}
+
+inline void append(Rope* rope, const char* c_string)
+{
+    append(rope, c_string, length_of_c_style_string(c_string));
+}
+
+inline void insert(Rope* rope, umm at_offset, String string)
+{
+    insert(rope, at_offset, string.data, string.length);
+}
+
+inline void insert(Rope* rope, umm at_offset, const char* c_string)
+{
+    insert(rope, at_offset, c_string, length_of_c_style_string(c_string));
+}